@@ -0,0 +1,59 @@
+# Script mode helper for ocl_embed_kernels (see OclEmbed.cmake)
+#
+# Inputs:  ENTRIES  - file with one "name|kind|device|path" line per file
+#                     (device is "-" for sources)
+#          OUTPUT   - generated C++ file
+#          FUNCTION - optional registration function name
+
+file(STRINGS ${ENTRIES} entries)
+
+set(byte_x16 "")
+foreach(i RANGE 15)
+    string(APPEND byte_x16 "0x[0-9a-f][0-9a-f],")
+endforeach()
+
+set(arrays "")
+set(table "")
+set(index 0)
+
+foreach(entry ${entries})
+    string(REPLACE "|" ";" fields "${entry}")
+    list(GET fields 0 name)
+    list(GET fields 1 kind)
+    list(GET fields 2 device)
+    list(GET fields 3 path)
+    if(device STREQUAL "-")
+        set(device "")
+    endif()
+
+    file(READ ${path} hex HEX)
+    string(LENGTH "${hex}" hex_length)
+    math(EXPR size "${hex_length} / 2")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex}")
+    # 16 bytes per line (CMake regexes have no {n} repetition)
+    string(REGEX REPLACE "(${byte_x16})" "\\1\n    " bytes "${bytes}")
+
+    if(kind STREQUAL "source")
+        set(kind_enum "ocl::EmbeddedFile::Source")
+    elseif(kind STREQUAL "il")
+        set(kind_enum "ocl::EmbeddedFile::IL")
+    else()
+        set(kind_enum "ocl::EmbeddedFile::Binary")
+    endif()
+
+    # Trailing null keeps sources usable as C strings (not counted in size)
+    string(APPEND arrays "// ${name} (${kind})\nconstexpr unsigned char data${index}[] = {\n    ${bytes}0x00\n};\n\n")
+    string(APPEND table "    {\"${name}\", ${kind_enum}, \"${device}\", data${index}, ${size}},\n")
+    math(EXPR index "${index} + 1")
+endforeach()
+
+set(content "// Generated by ocl_embed_kernels - do not edit\n\n#include <ocl/Embedded.hpp>\n\nnamespace {\n\n${arrays}")
+string(APPEND content "constexpr ocl::EmbeddedFile files[] = {\n${table}};\n\n} // namespace\n\n")
+
+if(FUNCTION)
+    string(APPEND content "void ${FUNCTION}() {\n    ocl::registerEmbeddedFiles(files, sizeof(files) / sizeof(files[0]));\n}\n")
+else()
+    string(APPEND content "namespace {\nconst ocl::EmbeddedRegistration registration(files, sizeof(files) / sizeof(files[0]));\n} // namespace\n")
+endif()
+
+file(WRITE ${OUTPUT} "${content}")
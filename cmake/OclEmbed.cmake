@@ -0,0 +1,109 @@
+# ============================================================================
+# ocl_embed_kernels - embed OpenCL kernel files into a target
+# ============================================================================
+#
+# ocl_embed_kernels(<target>
+#     SOURCES <file.cl>...
+#     [FUNCTION <name>]
+#     [OFFLINE_COMPILER <exe> OFFLINE_DEVICE <device-name>
+#      [OFFLINE_COMPILER_ARGS <arg>...]]
+#     [SPIRV_COMPILER <clang> SPIRV_TRANSLATOR <llvm-spirv>
+#      [SPIRV_ARGS <arg>...]])
+#
+# Each file is compiled into <target> as a constexpr byte array and
+# registered with ocl's embedded file table under its file name, so
+# Program::fromEmbedded(ctx, "vector_add.cl") works without touching the
+# filesystem.
+#
+# FUNCTION names a global `void <name>()` that performs the registration
+# (needed when <target> is a static library, where a self-registering
+# object file could be dropped by the linker). Without it, registration
+# happens during static initialization.
+#
+# With OFFLINE_COMPILER, each file is also precompiled at build time by
+# running `<exe> <args> -o <out> <file.cl>` (e.g. poclcc), and the
+# binary is embedded for the device whose CL_DEVICE_NAME equals
+# OFFLINE_DEVICE. Program::buildEmbedded() prefers that binary on a
+# matching device and falls back to the source everywhere else.
+#
+# With SPIRV_COMPILER, each file is also compiled to SPIR-V at build time
+# (clang to SPIR LLVM bitcode, then llvm-spirv) and embedded as IL.
+# Devices that accept IL then skip the OpenCL C front end entirely; the
+# module is device independent, so one build serves every such driver.
+
+set(OCL_EMBED_SCRIPT ${CMAKE_CURRENT_LIST_DIR}/EmbedFiles.cmake)
+
+function(ocl_embed_kernels target)
+    cmake_parse_arguments(EMBED ""
+        "FUNCTION;OFFLINE_COMPILER;OFFLINE_DEVICE;SPIRV_COMPILER;SPIRV_TRANSLATOR"
+        "SOURCES;OFFLINE_COMPILER_ARGS;SPIRV_ARGS" ${ARGN})
+
+    if(NOT EMBED_SOURCES)
+        message(FATAL_ERROR "ocl_embed_kernels: no SOURCES given")
+    endif()
+    if(EMBED_OFFLINE_COMPILER AND NOT EMBED_OFFLINE_DEVICE)
+        message(FATAL_ERROR "ocl_embed_kernels: OFFLINE_COMPILER requires OFFLINE_DEVICE")
+    endif()
+    if(EMBED_SPIRV_COMPILER AND NOT EMBED_SPIRV_TRANSLATOR)
+        message(FATAL_ERROR "ocl_embed_kernels: SPIRV_COMPILER requires SPIRV_TRANSLATOR")
+    endif()
+
+    set(out_dir ${CMAKE_CURRENT_BINARY_DIR}/generated)
+    set(output ${out_dir}/${target}_embedded.cpp)
+    set(entries "")
+    set(depends "")
+
+    foreach(source ${EMBED_SOURCES})
+        get_filename_component(path ${source} ABSOLUTE)
+        get_filename_component(name ${source} NAME)
+        list(APPEND entries "${name}|source|-|${path}")
+        list(APPEND depends ${path})
+
+        if(EMBED_OFFLINE_COMPILER)
+            set(binary ${out_dir}/${name}.bin)
+            add_custom_command(
+                OUTPUT ${binary}
+                COMMAND ${EMBED_OFFLINE_COMPILER} ${EMBED_OFFLINE_COMPILER_ARGS} -o ${binary} ${path}
+                DEPENDS ${path}
+                COMMENT "Precompiling ${name} for ${EMBED_OFFLINE_DEVICE}"
+                VERBATIM
+            )
+            list(APPEND entries "${name}|binary|${EMBED_OFFLINE_DEVICE}|${binary}")
+            list(APPEND depends ${binary})
+        endif()
+
+        if(EMBED_SPIRV_COMPILER)
+            set(bitcode ${out_dir}/${name}.bc)
+            set(spirv ${out_dir}/${name}.spv)
+            add_custom_command(
+                OUTPUT ${spirv}
+                COMMAND ${EMBED_SPIRV_COMPILER} -c -x cl -target spir64 -emit-llvm
+                    -Xclang -finclude-default-header ${EMBED_SPIRV_ARGS} -o ${bitcode} ${path}
+                COMMAND ${EMBED_SPIRV_TRANSLATOR} ${bitcode} -o ${spirv}
+                DEPENDS ${path}
+                COMMENT "Compiling ${name} to SPIR-V"
+                VERBATIM
+            )
+            list(APPEND entries "${name}|il|-|${spirv}")
+            list(APPEND depends ${spirv})
+        endif()
+    endforeach()
+
+    # Entries are ';'-separated; pass them through a file to avoid quoting issues
+    string(REPLACE ";" "\n" entry_lines "${entries}")
+    file(WRITE ${out_dir}/${target}_embedded.txt "${entry_lines}\n")
+
+    add_custom_command(
+        OUTPUT ${output}
+        COMMAND ${CMAKE_COMMAND}
+            -DOUTPUT=${output}
+            -DENTRIES=${out_dir}/${target}_embedded.txt
+            -DFUNCTION=${EMBED_FUNCTION}
+            -P ${OCL_EMBED_SCRIPT}
+        DEPENDS ${depends} ${out_dir}/${target}_embedded.txt ${OCL_EMBED_SCRIPT}
+        COMMENT "Embedding OpenCL kernels into ${target}"
+        VERBATIM
+    )
+
+    target_sources(${target} PRIVATE ${output})
+endfunction()
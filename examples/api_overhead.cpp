@@ -0,0 +1,222 @@
+#include <ocl/ocl.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Wrapper overhead: each ocl:: call against the raw cl* call it wraps,
+// in ns/op and heap allocations/op.
+//
+// Usage: api_overhead [--json results.json]
+
+// Counting allocator: every operator new in this program bumps the counter
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+struct Overhead {
+    double ns_per_op;
+    double allocs_per_op;
+};
+
+// Time `ops` calls of `op` per sample; `after` (e.g. a finish) runs once per batch
+template<typename Op, typename After>
+Overhead measure(ocl::Benchmark& bench, const std::string& name, int ops, Op op, After after) {
+    auto batch = [&]() {
+        for (int i = 0; i < ops; ++i) {
+            op();
+        }
+        after();
+    };
+    
+    batch();  // Prime lazy allocations before counting
+    size_t before = g_allocations.load();
+    batch();
+    double allocs = double(g_allocations.load() - before) / ops;
+    
+    const auto& result = bench.run(name, batch);
+    return {result.median_ms * 1e6 / ops, allocs};
+}
+
+template<typename Op>
+Overhead measure(ocl::Benchmark& bench, const std::string& name, int ops, Op op) {
+    return measure(bench, name, ops, op, []() {});
+}
+
+void printRow(const std::string& name, const Overhead& raw, const Overhead& wrapped) {
+    std::cout << std::left << std::setw(26) << name
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << raw.ns_per_op
+              << std::setw(10) << wrapped.ns_per_op
+              << std::showpos << std::setw(10) << wrapped.ns_per_op - raw.ns_per_op << std::noshowpos
+              << std::setprecision(2)
+              << std::setw(10) << raw.allocs_per_op
+              << std::setw(10) << wrapped.allocs_per_op << "\n";
+}
+
+int main(int argc, char** argv) {
+    std::string json_path;
+    if (argc > 2 && std::string(argv[1]) == "--json") {
+        json_path = argv[2];
+    }
+    
+    try {
+        auto device = ocl::Device::getDefault();
+        ocl::Context ctx(device);
+        ocl::CommandQueue queue(ctx, device);
+        
+        ocl::BenchmarkConfig config;
+        config.print = false;
+        config.max_time_ms = 1000.0;
+        ocl::Benchmark bench(config);
+        for (const auto& entry : ocl::Registry::instance().getDeviceMetadata(device)) {
+            bench.setMetadata(entry.first, entry.second);
+        }
+        
+        std::cout << "\nWrapper Overhead (" << device.getName() << ")\n";
+        std::cout << "══════════════════════════════════════════════════════════════════════════════\n";
+        std::cout << std::left << std::setw(26) << "Operation"
+                  << std::right << std::setw(10) << "raw ns"
+                  << std::setw(10) << "ocl ns"
+                  << std::setw(10) << "Δ ns"
+                  << std::setw(10) << "raw alloc"
+                  << std::setw(10) << "ocl alloc" << "\n";
+        std::cout << "──────────────────────────────────────────────────────────────────────────────\n";
+        
+        const size_t N = 1024;
+        ocl::Buffer<float> buf_a(ctx, N), buf_b(ctx, N), buf_c(ctx, N);
+        cl_mem mem_a = buf_a.get(), mem_b = buf_b.get(), mem_c = buf_c.get();
+        const int n = static_cast<int>(N);
+        
+        ocl::Program prog = ocl::Program::buildEmbedded(ctx, device, "vector_add.cl");
+        ocl::Kernel kernel(prog, "vector_add");
+        ocl::KernelFunctor<ocl::Buffer<float>, ocl::Buffer<float>, ocl::Buffer<float>, int> functor(prog, "vector_add");
+        cl_kernel raw_kernel = kernel.get();
+        cl_command_queue raw_queue = queue.get();
+        const auto range = ocl::Range::of1D(N);
+        
+        const int FAST_OPS = 10000;  // Host-only calls
+        const int ENQUEUE_OPS = 100; // Calls that reach the driver queue
+        
+        // setArg: one buffer argument
+        printRow("setArg (buffer)",
+            measure(bench, "setArg/raw", FAST_OPS, [&]() {
+                clSetKernelArg(raw_kernel, 0, sizeof(cl_mem), &mem_a);
+            }),
+            measure(bench, "setArg/ocl", FAST_OPS, [&]() {
+                kernel.setArg(0, buf_a);
+            }));
+        
+        // setArgs: the full vector_add signature
+        printRow("setArgs (4 args)",
+            measure(bench, "setArgs/raw", FAST_OPS, [&]() {
+                clSetKernelArg(raw_kernel, 0, sizeof(cl_mem), &mem_a);
+                clSetKernelArg(raw_kernel, 1, sizeof(cl_mem), &mem_b);
+                clSetKernelArg(raw_kernel, 2, sizeof(cl_mem), &mem_c);
+                clSetKernelArg(raw_kernel, 3, sizeof(int), &n);
+            }),
+            measure(bench, "setArgs/ocl", FAST_OPS, [&]() {
+                kernel.setArgs(buf_a, buf_b, buf_c, n);
+            }));
+        
+        // checkError on the success path
+        volatile cl_int status = CL_SUCCESS;
+        printRow("checkError",
+            measure(bench, "checkError/raw", FAST_OPS, [&]() {
+                if (status != CL_SUCCESS) {
+                    throw ocl::Error(status, "raw");
+                }
+            }),
+            measure(bench, "checkError/ocl", FAST_OPS, [&]() {
+                ocl::checkError(status, "executing kernel");
+            }));
+        
+        // Work group selection vs the queries it is built on
+        printRow("NDRange::getOptimal1D",
+            measure(bench, "getOptimal1D/raw", FAST_OPS, [&]() {
+                size_t max_size, multiple;
+                clGetKernelWorkGroupInfo(raw_kernel, device.id(), CL_KERNEL_WORK_GROUP_SIZE,
+                                         sizeof(size_t), &max_size, nullptr);
+                clGetKernelWorkGroupInfo(raw_kernel, device.id(), CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
+                                         sizeof(size_t), &multiple, nullptr);
+            }),
+            measure(bench, "getOptimal1D/ocl", FAST_OPS, [&]() {
+                ocl::NDRange::getOptimal1D(kernel, device, N);
+            }));
+        
+        kernel.setArgs(buf_a, buf_b, buf_c, n);
+        auto finish = [&]() { queue.finish(); };
+        
+        // Kernel launch (arguments already set)
+        printRow("execute",
+            measure(bench, "execute/raw", ENQUEUE_OPS, [&]() {
+                size_t global = N;
+                clEnqueueNDRangeKernel(raw_queue, raw_kernel, 1, nullptr, &global, nullptr, 0, nullptr, nullptr);
+            }, finish),
+            measure(bench, "execute/ocl", ENQUEUE_OPS, [&]() {
+                kernel.execute(queue, N);
+            }, finish));
+        
+        // Typed functor: binds all arguments, launches and returns an Event
+        printRow("KernelFunctor call",
+            measure(bench, "functor/raw", ENQUEUE_OPS, [&]() {
+                size_t global = N;
+                cl_event event;
+                clSetKernelArg(raw_kernel, 0, sizeof(cl_mem), &mem_a);
+                clSetKernelArg(raw_kernel, 1, sizeof(cl_mem), &mem_b);
+                clSetKernelArg(raw_kernel, 2, sizeof(cl_mem), &mem_c);
+                clSetKernelArg(raw_kernel, 3, sizeof(int), &n);
+                clEnqueueNDRangeKernel(raw_queue, raw_kernel, 1, nullptr, &global, nullptr, 0, nullptr, &event);
+                clReleaseEvent(event);
+            }, finish),
+            measure(bench, "functor/ocl", ENQUEUE_OPS, [&]() {
+                functor(queue, range, buf_a, buf_b, buf_c, n);
+            }, finish));
+        
+        // Event creation and release
+        printRow("Event (marker)",
+            measure(bench, "event/raw", ENQUEUE_OPS, [&]() {
+                cl_event event;
+                clEnqueueMarkerWithWaitList(raw_queue, 0, nullptr, &event);
+                clReleaseEvent(event);
+            }, finish),
+            measure(bench, "event/ocl", ENQUEUE_OPS, [&]() {
+                ocl::Event event = queue.enqueueMarker();
+            }, finish));
+        
+        // Buffer construction and release
+        printRow("Buffer (4 KB)",
+            measure(bench, "buffer/raw", ENQUEUE_OPS, [&]() {
+                cl_int err;
+                cl_mem mem = clCreateBuffer(ctx.get(), CL_MEM_READ_WRITE, N * sizeof(float), nullptr, &err);
+                clReleaseMemObject(mem);
+            }),
+            measure(bench, "buffer/ocl", ENQUEUE_OPS, [&]() {
+                ocl::Buffer<float> buffer(ctx, N);
+            }));
+        
+        std::cout << "══════════════════════════════════════════════════════════════════════════════\n";
+        
+        if (!json_path.empty()) {
+            std::cout << (bench.writeJSON(json_path) ? "Results written to " : "Failed to write ") << json_path << "\n";
+        }
+        
+    } catch (const ocl::Error& e) {
+        std::cerr << "OpenCL error: " << e.what() << "\n";
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <ocl/ocl.hpp>
+#include <iostream>
+#include <vector>
+
+// Device → host → device pipeline without blocking between stages:
+//   1. GPU:  c = a + b
+//   2. CPU:  c[i] *= 2 and upload (host task, runs when the read-back completes)
+//   3. GPU:  d = c + b (waits on the host task's user event)
+int main() {
+    try {
+        // Initialize
+        auto device = ocl::Device::getDefault();
+        ocl::Context ctx(device);
+        ocl::CommandQueue queue(ctx, device);
+        ocl::CommandQueue upload(ctx, device);  // Host task's transfers
+        ocl::ThreadPoolExecutor pool(2);
+        
+        std::cout << "Async Pipeline (" << device.getName() << ")\n";
+        std::cout << "═══════════════════════════════════════════════════\n";
+        
+        const size_t N = 1024 * 1024;
+        std::vector<float> a(N, 1.0f), b(N, 2.0f), host_c, d;
+        
+        ocl::Buffer<float> buf_a(ctx, a);
+        ocl::Buffer<float> buf_b(ctx, b);
+        ocl::Buffer<float> buf_c(ctx, N);
+        ocl::Buffer<float> buf_d(ctx, N);
+        
+        ocl::Program prog = ocl::Program::buildEmbedded(ctx, device, "vector_add.cl");
+        ocl::KernelFunctor<ocl::Buffer<float>, ocl::Buffer<float>, ocl::Buffer<float>, int> vector_add(prog, "vector_add");
+        size_t local = ocl::NDRange::getOptimal1D(vector_add.getKernel(), device, N);
+        auto range = ocl::Range::of1D(ocl::NDRange::getPaddedGlobalSize(N, local), local);
+        
+        // Stage 1 (device) and non-blocking read-back
+        vector_add(queue, range, buf_a, buf_b, buf_c, static_cast<int>(N));
+        cl_event read_handle;
+        buf_c.readAsync(queue, host_c, read_handle);
+        ocl::Event read_done(read_handle);
+        
+        // Stage 2 (host): scheduled by the read's completion callback. The
+        // task uploads its result itself: a non-blocking write enqueued
+        // earlier may copy host_c as soon as it is enqueued, before the
+        // doubling. It uses its own queue, since commands after the barrier
+        // on `queue` wait for this task.
+        ocl::Event host_done = ocl::hostTask(ctx, pool, ocl::waitList(read_done), [&]() {
+            for (auto& value : host_c) {
+                value *= 2.0f;
+            }
+            buf_c.write(upload, host_c);  // Blocking: done before host_done completes
+        });
+        
+        // Stage 3 (device): everything after the barrier waits for the host
+        // task, and so for its upload
+        queue.enqueueBarrier(ocl::waitList(host_done));
+        ocl::Event final_done = vector_add(queue, range, buf_c, buf_b, buf_d, static_cast<int>(N));
+        queue.flush();
+        
+        std::cout << "Stages enqueued; host thread is free\n";
+        
+        // Only now wait, through a future
+        std::future<void> finished = ocl::toFuture(final_done);
+        finished.get();
+        buf_d.read(queue, d);
+        
+        // (1 + 2) * 2 + 2 = 8
+        bool correct = (d[0] == 8.0f && d[N/2] == 8.0f && d[N-1] == 8.0f);
+        
+        std::cout << "Result:       " << (correct ? "✓ CORRECT" : "✗ INCORRECT") << "\n";
+        std::cout << "═══════════════════════════════════════════════════\n";
+        
+        return correct ? 0 : 1;
+        
+    } catch (const ocl::Error& e) {
+        std::cerr << "OpenCL error: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -1,78 +1,81 @@
 #include <ocl/ocl.hpp>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <vector>
 #include <chrono>
 #include <iomanip>
+#include <string>
+#include <thread>
 
 using Clock = std::chrono::high_resolution_clock;
 using Duration = std::chrono::duration<double, std::milli>;
 
-template<typename Func>
-double benchmark(const std::string& name, int iterations, Func func) {
-    auto start = Clock::now();
-    for (int i = 0; i < iterations; ++i) {
-        func();
-    }
-    auto end = Clock::now();
-    Duration elapsed = end - start;
-    double avg = elapsed.count() / iterations;
-    
-    std::cout << std::left << std::setw(40) << name
-              << std::right << std::fixed << std::setprecision(3)
-              << std::setw(12) << elapsed.count() << " ms"
-              << std::setw(12) << avg << " ms/iter\n";
-    
-    return avg;
+void printSection(const std::string& title) {
+    std::cout << "\n" << title << "\n";
+    std::cout << "──────────────────────────────────────────────────────────────────\n";
+    ocl::Benchmark::printHeader(std::cout);
 }
 
-int main() {
+// Usage: benchmark [--json results.json] [--csv results.csv]
+int main(int argc, char** argv) {
+    std::string json_path, csv_path;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--json") {
+            json_path = argv[i + 1];
+        } else if (flag == "--csv") {
+            csv_path = argv[i + 1];
+        }
+    }
+    
     try {
         auto device = ocl::Device::getDefault();
         ocl::Context ctx(device);
-        ocl::CommandQueue queue(ctx, device);
+        ocl::CommandQueue queue(ctx, device, CL_QUEUE_PROFILING_ENABLE);
+        
+        ocl::Benchmark bench;
+        for (const auto& entry : ocl::Registry::instance().getDeviceMetadata(device)) {
+            bench.setMetadata(entry.first, entry.second);
+        }
+        
+        // Every KernelFunctor launch is also accounted per kernel (see the end)
+        ocl::Profiler::instance().setKernelProfiling(true);
         
         std::cout << "\nPerformance Benchmarks\n";
         std::cout << "══════════════════════════════════════════════════════════════════\n";
         std::cout << "Device:         " << device.getName() << "\n";
         std::cout << "Type:           " << (device.isGPU() ? "GPU" : "CPU") << "\n";
         std::cout << "Compute Units:  " << device.getMaxComputeUnits() << "\n";
-        std::cout << "══════════════════════════════════════════════════════════════════\n\n";
+        std::cout << "══════════════════════════════════════════════════════════════════\n";
         
         // Buffer Transfer Benchmarks
-        std::cout << "1. Buffer Transfer Performance (4 MB)\n";
-        std::cout << "──────────────────────────────────────────────────────────────────\n";
-        
         const size_t N = 1024 * 1024;  // 1M floats = 4MB
+        const double bytes = N * sizeof(float);
         std::vector<float> hostData(N, 1.0f);
         std::vector<float> resultData;
         ocl::Buffer<float> buf(ctx, N);
         
-        std::cout << std::left << std::setw(40) << "Operation"
-                  << std::right << std::setw(12) << "Total"
-                  << std::setw(12) << "Average\n";
-        std::cout << "──────────────────────────────────────────────────────────────────\n";
+        printSection("1. Buffer Transfer Performance (4 MB)");
         
-        benchmark("Host → Device (write)", 10, [&]() {
+        bench.run("Host → Device (write)", [&]() {
             buf.write(queue, hostData);
-        });
+        }, bytes);
         
-        benchmark("Device → Host (read)", 10, [&]() {
+        bench.run("Device → Host (read)", [&]() {
             buf.read(queue, resultData);
-        });
+        }, bytes);
         
-        benchmark("Round-trip (write + read)", 10, [&]() {
+        bench.run("Round-trip (write + read)", [&]() {
             buf.write(queue, hostData);
             buf.read(queue, resultData);
-        });
+        }, 2 * bytes);
         
-        benchmark("Buffer fill", 10, [&]() {
+        bench.run("Buffer fill", [&]() {
             buf.fill(queue, 0.0f);
-        });
+        }, bytes);
         
         // Kernel Execution Benchmarks
-        std::cout << "\n2. Kernel Execution Performance (1M elements)\n";
-        std::cout << "──────────────────────────────────────────────────────────────────\n";
-        
         ocl::Buffer<float> buf_a(ctx, N);
         ocl::Buffer<float> buf_b(ctx, N);
         ocl::Buffer<float> buf_c(ctx, N);
@@ -80,90 +83,259 @@ int main() {
         buf_a.fill(queue, 1.0f);
         buf_b.fill(queue, 2.0f);
         
-        // Test with optimized build
+        // Test with optimized build (arg info lets the functor check its signature)
         ocl::Program prog = ocl::Program::fromFile(ctx, "vector_add.cl");
-        prog.buildOptimized(device);
-        ocl::Kernel kernel(prog, "vector_add");
-        kernel.setArgs(buf_a, buf_b, buf_c, static_cast<int>(N));
+        prog.buildOptimized(device, "-cl-kernel-arg-info");
+        ocl::KernelFunctor<ocl::Buffer<float>, ocl::Buffer<float>, ocl::Buffer<float>, int> vector_add(prog, "vector_add");
         
         // Calculate optimal work group
-        size_t local = ocl::NDRange::getOptimal1D(kernel, device, N);
+        size_t local = ocl::NDRange::getOptimal1D(vector_add.getKernel(), device, N);
         size_t global = ocl::NDRange::getPaddedGlobalSize(N, local);
         
-        std::cout << std::left << std::setw(40) << "Operation"
-                  << std::right << std::setw(12) << "Total"
-                  << std::setw(12) << "Average\n";
-        std::cout << "──────────────────────────────────────────────────────────────────\n";
+        printSection("2. Kernel Execution Performance (1M elements)");
         
-        benchmark("Kernel (auto work group " + std::to_string(local) + ")", 100, [&]() {
-            kernel.execute(queue, global, local);
-            queue.finish();
-        });
+        bench.runEvent("Kernel (auto work group " + std::to_string(local) + ")", [&]() {
+            return vector_add(queue, ocl::Range::of1D(global, local), buf_a, buf_b, buf_c, static_cast<int>(N));
+        }, 3 * bytes, N);
         
         // Buffer Copy Benchmarks
-        std::cout << "\n3. Buffer Copy Performance (GPU vs CPU)\n";
-        std::cout << "──────────────────────────────────────────────────────────────────\n";
-        
         ocl::Buffer<float> src(ctx, N);
         ocl::Buffer<float> dst(ctx, N);
         src.fill(queue, 1.0f);
         
-        std::cout << std::left << std::setw(40) << "Operation"
-                  << std::right << std::setw(12) << "Total"
-                  << std::setw(12) << "Average\n";
-        std::cout << "──────────────────────────────────────────────────────────────────\n";
+        printSection("3. Buffer Copy Performance (GPU vs CPU)");
         
-        double gpu_time = benchmark("GPU-side copy", 10, [&]() {
+        double gpu_time = bench.run("GPU-side copy", [&]() {
             src.copyTo(queue, dst, N);
             queue.finish();
-        });
+        }, 2 * bytes).median_ms;
         
         std::vector<float> temp;
-        double cpu_time = benchmark("CPU round-trip", 10, [&]() {
+        double cpu_time = bench.run("CPU round-trip", [&]() {
             src.read(queue, temp);
             dst.write(queue, temp);
-        });
+        }, 2 * bytes).median_ms;
         
         double speedup = cpu_time / gpu_time;
         std::cout << "\nSpeedup: " << std::fixed << std::setprecision(1) 
                   << speedup << "x (GPU-side copy vs CPU round-trip)\n";
         
-        // Compilation Benchmarks
-        std::cout << "\n4. Program Compilation Performance\n";
-        std::cout << "──────────────────────────────────────────────────────────────────\n";
-        
+        // Compilation Benchmarks: few samples, each run takes a while
         const std::string cache_file = "bench_cache.bin";
+        ocl::BenchmarkConfig slow_config;
+        slow_config.warmup_iterations = 1;
+        slow_config.min_samples = 5;
+        slow_config.max_samples = 20;
+        slow_config.min_time_ms = 0.0;
+        bench.setConfig(slow_config);
         
-        std::cout << std::left << std::setw(40) << "Operation"
-                  << std::right << std::setw(12) << "Total"
-                  << std::setw(12) << "Average\n";
-        std::cout << "──────────────────────────────────────────────────────────────────\n";
+        printSection("4. Program Compilation Performance");
         
-        double compile_time = benchmark("Compile from source", 5, [&]() {
+        double compile_time = bench.run("Compile from source", [&]() {
             ocl::Program p = ocl::Program::fromFile(ctx, "vector_add.cl");
             p.build(device);
-        });
+        }).median_ms;
         
         // Save binary
         ocl::Program prog_for_save = ocl::Program::fromFile(ctx, "vector_add.cl");
         prog_for_save.build(device);
         prog_for_save.saveBinary(device, cache_file);
         
-        double binary_time = benchmark("Load from binary", 5, [&]() {
+        double binary_time = bench.run("Load from binary", [&]() {
             ocl::Program p = ocl::Program::fromBinary(ctx, device, cache_file);
-        });
+        }).median_ms;
         
         std::remove(cache_file.c_str());
+        bench.setConfig(ocl::BenchmarkConfig());
         
         speedup = compile_time / binary_time;
         std::cout << "\nSpeedup: " << std::fixed << std::setprecision(1)
                   << speedup << "x (binary cache vs recompiling)\n";
         
+        // Quantized GEMM Benchmarks
+        const size_t GM = 512, GN = 512, GK = 512;
+        const double gemm_ops = 2.0 * GM * GN * GK;
+        
+        ocl::Buffer<float> gemm_A(ctx, GM * GK);
+        ocl::Buffer<float> gemm_B(ctx, GK * GN);
+        ocl::Buffer<float> gemm_C(ctx, GM * GN);
+        gemm_A.fill(queue, 1.0f);
+        gemm_B.fill(queue, 2.0f);
+        
+        ocl::Program float_prog = ocl::Program::fromFile(ctx, "matmul_tiled.cl");
+        float_prog.buildOptimized(device);
+        ocl::KernelFunctor<ocl::Buffer<float>, ocl::Buffer<float>, ocl::Buffer<float>, int, int, int>
+            float_gemm(float_prog, "matmul_tiled");
+        float_gemm.setCostModel([](const ocl::Range&, const ocl::Buffer<float>&, const ocl::Buffer<float>&,
+                                   const ocl::Buffer<float>&, int m, int k, int n) {
+            ocl::KernelCost cost;
+            cost.bytes_read = 4.0 * (double(m) * k + double(k) * n);
+            cost.bytes_written = 4.0 * m * n;
+            cost.flops = 2.0 * m * n * k;
+            return cost;
+        });
+        
+        // int8 operands (B stored N x K) with per-channel zero points
+        ocl::Buffer<cl_char> gemm_qA(ctx, GM * GK);
+        ocl::Buffer<cl_char> gemm_qB(ctx, GN * GK);
+        ocl::Buffer<int> gemm_acc(ctx, GM * GN);
+        ocl::Buffer<int> gemm_zero(ctx, GN);
+        gemm_qA.fill(queue, 1);
+        gemm_qB.fill(queue, 2);
+        gemm_zero.fill(queue, 0);
+        
+        ocl::Program quant_prog = ocl::Program::fromFile(ctx, "quantized.cl");
+        quant_prog.buildOptimized(device);
+        ocl::KernelFunctor<ocl::Buffer<cl_char>, ocl::Buffer<cl_char>, ocl::Buffer<int>, int, int, int, int, ocl::Buffer<int>>
+            int8_gemm(quant_prog, "gemm_int8");
+        auto int8_local = ocl::NDRange::getOptimal2D(int8_gemm.getKernel(), device, GM, GN);
+        
+        printSection("5. Quantized GEMM Performance (int8 vs float, 512³)");
+        std::cout << "Integer dot product: " << (device.supportsIntegerDotProduct() ? "yes" : "no (packed char4)") << "\n";
+        
+        const int M = static_cast<int>(GM), K = static_cast<int>(GK), Ncols = static_cast<int>(GN);
+        const auto& float_result = bench.runEvent("float GEMM (matmul_tiled)", [&]() {
+            return float_gemm(queue, ocl::Range::of2D(GM, GN, 16, 16), gemm_A, gemm_B, gemm_C, M, K, Ncols);
+        }, 4.0 * (GM * GK + GK * GN + GM * GN), gemm_ops);
+        double float_gemm_gflops = float_result.getGFLOPPerSecond();
+        
+        const auto& int8_result = bench.runEvent("int8 GEMM (gemm_int8)", [&]() {
+            auto range = ocl::Range::of2D(ocl::NDRange::getPaddedGlobalSize(GM, int8_local[0]),
+                                          ocl::NDRange::getPaddedGlobalSize(GN, int8_local[1]),
+                                          int8_local[0], int8_local[1]);
+            return int8_gemm(queue, range, gemm_qA, gemm_qB, gemm_acc, M, Ncols, K, 0, gemm_zero);
+        }, 1.0 * (GM * GK + GN * GK) + 4.0 * GM * GN, gemm_ops);
+        
+        std::cout << "\nThroughput: " << std::fixed << std::setprecision(1)
+                  << float_gemm_gflops << " GFLOP/s (float), "
+                  << int8_result.getGFLOPPerSecond() << " GOP/s (int8)\n";
+        
+        // Reduction Benchmarks
+        const size_t RED_GROUP = 256;
+        const size_t RED_GROUPS = N / RED_GROUP;
+        ocl::Buffer<float> red_partials(ctx, RED_GROUPS);
+        
+        const bool use_subgroups = device.supportsSubgroups();
+        ocl::Program red_prog = ocl::Program::fromFile(ctx, "reduction.cl");
+        red_prog.buildOptimized(device, use_subgroups ? "-cl-std=CL2.0" : "");
+        
+        printSection("6. Reduction Performance (tree vs sub-group, 1M elements)");
+        
+        using ReduceFunctor = ocl::KernelFunctor<ocl::Buffer<float>, ocl::Buffer<float>, ocl::Local<float>, int>;
+        const auto red_range = ocl::Range::of1D(N, RED_GROUP);
+        
+        ReduceFunctor tree_reduce(red_prog, "reduce_sum");
+        double tree_time = bench.runEvent("reduce_sum (tree)", [&]() {
+            return tree_reduce(queue, red_range, buf_a, red_partials, ocl::Local<float>(RED_GROUP), static_cast<int>(N));
+        }, bytes, N).median_ms;
+        
+        if (use_subgroups) {
+            ReduceFunctor sg_reduce(red_prog, "reduce_sum_subgroup");
+            double sg_time = bench.runEvent("reduce_sum_subgroup", [&]() {
+                return sg_reduce(queue, red_range, buf_a, red_partials, ocl::Local<float>(RED_GROUP), static_cast<int>(N));
+            }, bytes, N).median_ms;
+            
+            std::cout << "\nSpeedup: " << std::fixed << std::setprecision(1)
+                      << tree_time / sg_time << "x (sub-group vs tree reduction)\n";
+        } else {
+            std::cout << "\nSub-groups not supported - tree reduction only\n";
+        }
+        
+        // Vectorized Element-wise Benchmarks
+        const cl_uint preferred_width = device.getPreferredVectorWidthFloat();
+        
+        printSection("7. Element-wise Bandwidth by Vector Width (c = a + b, 1M elements)");
+        std::cout << "Preferred float width: " << preferred_width << "\n";
+        
+        double scalar_time = 0.0;
+        for (cl_uint width : {1u, 2u, 4u, 8u, 16u}) {
+            ocl::ElementWise add(ctx, device, "a + b", "float", width);
+            std::string label = (width == 1 ? std::string("float") : "float" + std::to_string(width))
+                              + (width == preferred_width ? " (preferred)" : "");
+            double time = bench.run(label, [&]() {
+                add.execute(queue, buf_a, buf_b, buf_c);
+                queue.finish();
+            }, 3 * bytes, N).median_ms;
+            if (width == 1) {
+                scalar_time = time;
+            }
+            std::cout << std::left << std::setw(34) << "" << std::right << std::fixed << std::setprecision(2)
+                      << scalar_time / time << "x vs scalar\n";
+        }
+        
+        // Multi-threaded Submission Benchmarks
+        std::cout << "\n8. Multi-threaded Submission (QueuePool + KernelPool, small kernels)\n";
+        std::cout << "──────────────────────────────────────────────────────────────────\n";
+        
+        const size_t SMALL_N = 4096;
+        const int SUBMITS_PER_THREAD = 200;
+        ocl::KernelPool kernel_pool(prog, "vector_add");
+        
+        std::cout << std::left << std::setw(12) << "Threads"
+                  << std::right << std::setw(16) << "Submits/s"
+                  << std::setw(18) << "Mean enqueue"
+                  << std::setw(16) << "Max depth\n";
+        std::cout << "──────────────────────────────────────────────────────────────────\n";
+        
+        const unsigned max_threads = std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            ocl::QueuePool queues(ctx, device, threads, ocl::QueueAssignment::LeastLoaded);
+            std::atomic<size_t> max_depth{0};
+            
+            auto start = Clock::now();
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back([&]() {
+                    for (int i = 0; i < SUBMITS_PER_THREAD; ++i) {
+                        auto lease = kernel_pool.acquire();
+                        lease->setArgs(buf_a, buf_b, buf_c, static_cast<int>(SMALL_N));
+                        queues.submit([&](ocl::CommandQueue& q) {
+                            lease->execute(q, SMALL_N);
+                            return ocl::Event();
+                        });
+                        size_t depth = 0;
+                        for (size_t q = 0; q < queues.size(); ++q) {
+                            depth += queues.getMetrics(q).depth;
+                        }
+                        size_t seen = max_depth.load();
+                        while (depth > seen && !max_depth.compare_exchange_weak(seen, depth)) {
+                        }
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            queues.finish();
+            Duration elapsed = Clock::now() - start;
+            
+            double mean_us = 0.0;
+            for (const auto& m : queues.getMetrics()) {
+                mean_us += m.mean_submit_us / queues.size();
+            }
+            std::cout << std::left << std::setw(12) << threads
+                      << std::right << std::fixed << std::setprecision(0)
+                      << std::setw(16) << threads * SUBMITS_PER_THREAD / (elapsed.count() / 1000.0)
+                      << std::setprecision(1) << std::setw(15) << mean_us << " us"
+                      << std::setw(15) << max_depth.load() << "\n";
+        }
+        std::cout << "Kernel instances created: " << kernel_pool.getInstanceCount() << "\n";
+        
+        // Per-kernel accounting (bytes derived from buffer sizes unless a cost model is set)
+        ocl::Profiler::instance().printKernelResults();
+        
         // Summary
         std::cout << "\n══════════════════════════════════════════════════════════════════\n";
-        std::cout << "Benchmark Complete!\n";
+        std::cout << "Benchmark Complete! (* = host-timed)\n";
         std::cout << "══════════════════════════════════════════════════════════════════\n\n";
         
+        if (!json_path.empty()) {
+            std::cout << (bench.writeJSON(json_path) ? "Results written to " : "Failed to write ") << json_path << "\n";
+        }
+        if (!csv_path.empty()) {
+            std::cout << (bench.writeCSV(csv_path) ? "Results written to " : "Failed to write ") << csv_path << "\n";
+        }
+        
     } catch (const ocl::Error& e) {
         std::cerr << "OpenCL error: " << e.what() << "\n";
         return 1;
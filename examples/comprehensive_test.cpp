@@ -1,5 +1,13 @@
 #include <ocl/ocl.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <sstream>
+#include <thread>
 #include <vector>
 #include <iomanip>
 
@@ -24,7 +32,7 @@ int main() {
         // ================================================================
         // 1. Buffer<T> Direct setArg
         // ================================================================
-        std::cout << "[1/10] Buffer<T> Direct setArg ... ";
+        std::cout << "[1/15] Buffer<T> Direct setArg ... ";
         tests_total++;
         try {
             const size_t N = 1000;
@@ -50,7 +58,7 @@ int main() {
         // ================================================================
         // 2. NDRange Automatic Work Group Sizing
         // ================================================================
-        std::cout << "[2/10] NDRange Optimal Sizing ... ";
+        std::cout << "[2/15] NDRange Optimal Sizing ... ";
         tests_total++;
         try {
             const size_t N = 1000000;
@@ -75,7 +83,7 @@ int main() {
         // ================================================================
         // 3. Kernel Compilation Flags
         // ================================================================
-        std::cout << "[3/10] Compilation Flags ... ";
+        std::cout << "[3/15] Compilation Flags ... ";
         tests_total++;
         try {
             ocl::Program prog_opt = ocl::Program::fromFile(ctx, "vector_add.cl");
@@ -94,7 +102,7 @@ int main() {
         // ================================================================
         // 4. Buffer Fill Operations
         // ================================================================
-        std::cout << "[4/10] Buffer Fill ... ";
+        std::cout << "[4/15] Buffer Fill ... ";
         tests_total++;
         try {
             const size_t N = 1000;
@@ -115,7 +123,7 @@ int main() {
         // ================================================================
         // 5. GPU-Side Buffer Copy
         // ================================================================
-        std::cout << "[5/10] GPU-Side Buffer Copy ... ";
+        std::cout << "[5/15] GPU-Side Buffer Copy ... ";
         tests_total++;
         try {
             const size_t N = 1000;
@@ -139,7 +147,7 @@ int main() {
         // ================================================================
         // 6. Error Code Mapping
         // ================================================================
-        std::cout << "[6/10] Error Code Mapping ... ";
+        std::cout << "[6/15] Error Code Mapping ... ";
         tests_total++;
         try {
             // Try to create an invalid buffer to trigger error
@@ -158,7 +166,7 @@ int main() {
         // ================================================================
         // 7. Async Buffer Operations
         // ================================================================
-        std::cout << "[7/10] Async Buffer I/O ... ";
+        std::cout << "[7/15] Async Buffer I/O ... ";
         tests_total++;
         try {
             const size_t N = 1000;
@@ -186,7 +194,7 @@ int main() {
         // ================================================================
         // 8. Buffer Mapping (Zero-Copy)
         // ================================================================
-        std::cout << "[8/10] Buffer Mapping ... ";
+        std::cout << "[8/15] Buffer Mapping ... ";
         tests_total++;
         try {
             const size_t N = 100;
@@ -207,7 +215,7 @@ int main() {
         // ================================================================
         // 9. Program Binary Caching
         // ================================================================
-        std::cout << "[9/10] Program Binary Cache ... ";
+        std::cout << "[9/15] Program Binary Cache ... ";
         tests_total++;
         try {
             const std::string cache_file = "test_cache.bin";
@@ -240,7 +248,7 @@ int main() {
         // ================================================================
         // 10. Device Type Predicates
         // ================================================================
-        std::cout << "[10/10] Device Predicates ... ";
+        std::cout << "[10/15] Device Predicates ... ";
         tests_total++;
         try {
             // Just verify predicates work without crashing
@@ -255,6 +263,314 @@ int main() {
             else { std::cout << "✗ FAIL\n"; }
         } catch (...) { std::cout << "✗ FAIL (exception)\n"; }
         
+        // ================================================================
+        // 11. Include-Aware Source Loading
+        // ================================================================
+        std::cout << "[11/15] SourceLoader Includes ... ";
+        tests_total++;
+        try {
+            auto writeFile = [](const std::string& path, const std::string& text) {
+                std::ofstream(path) << text;
+            };
+            writeFile("sl_common.h", "#pragma once\n#define SL_SCALE 2.0f\n");
+            writeFile("sl_main.cl", "#include \"sl_common.h\"\n#include \"sl_common.h\"\n"
+                                    "__kernel void scale(__global float* x) { x[get_global_id(0)] *= SL_SCALE; }\n");
+            writeFile("sl_cycle_a.h", "#include \"sl_cycle_b.h\"\n");
+            writeFile("sl_cycle_b.h", "#include \"sl_cycle_a.h\"\n");
+            
+            ocl::SourceLoader loader;
+            ocl::KernelSource source = loader.loadFile("sl_main.cl");
+            
+            // Resolved and inlined, once despite the second #include
+            const std::string define = "#define SL_SCALE";
+            const size_t first = source.text.find(define);
+            bool included = source.dependencies.size() == 1 && source.dependencies[0] == "sl_common.h" &&
+                            source.unresolved.empty() && first != std::string::npos;
+            bool once = included && source.text.find(define, first + 1) == std::string::npos;
+            
+            // #line markers enter the header and return to the next line
+            bool line_markers = source.text.find("#line 1 \"sl_common.h\"\n") != std::string::npos &&
+                                source.text.find("#line 2 \"sl_main.cl\"\n") != std::string::npos;
+            
+            bool cycle = false;
+            try {
+                loader.loadFile("sl_cycle_a.h");
+            } catch (const std::runtime_error&) {
+                cycle = true;
+            }
+            
+            // Editing only the header changes the hash of the including file
+            writeFile("sl_common.h", "#pragma once\n#define SL_SCALE 3.0f\n");
+            bool rehashed = loader.loadFile("sl_main.cl").hash != source.hash;
+            
+            // <...> includes are not searched next to the file: left to the
+            // compiler's -I, outside the hash, so buildCached must not reuse
+            // a binary after that header changes
+            auto fillValue = [&](const std::string& factor) {
+                writeFile("sl_factor.h", "#define SL_FACTOR " + factor + "\n");
+                ocl::KernelSource fill = loader.load("sl_fill.cl", "#include <sl_factor.h>\n"
+                    "__kernel void sl_fill(__global float* x) { x[get_global_id(0)] = SL_FACTOR; }\n");
+                ocl::Program prog = ocl::Program::buildCached(ctx, device, fill, "-I .", ".");
+                ocl::Kernel kernel(prog, "sl_fill");
+                ocl::Buffer<float> buf(ctx, 4);
+                std::vector<float> out;
+                kernel.setArgs(buf);
+                kernel.execute(queue, 4);
+                buf.read(queue, out);
+                return fill.unresolved.size() == 1 ? out[0] : -1.0f;
+            };
+            bool uncached = fillValue("2.0f") == 2.0f && fillValue("3.0f") == 3.0f;
+            
+            for (const char* file : {"sl_common.h", "sl_main.cl", "sl_cycle_a.h", "sl_cycle_b.h", "sl_factor.h"}) {
+                std::remove(file);
+            }
+            
+            if (included && once && line_markers && cycle && rehashed && uncached) { std::cout << "✓ PASS\n"; tests_passed++; }
+            else {
+                std::cout << "✗ FAIL (include=" << included << " once=" << once << " line=" << line_markers
+                          << " cycle=" << cycle << " hash=" << rehashed << " uncached=" << uncached << ")\n";
+            }
+        } catch (...) { std::cout << "✗ FAIL (exception)\n"; }
+        
+        // ================================================================
+        // 12. Deferred Handle Release
+        // ================================================================
+        std::cout << "[12/15] Deferred Release ... ";
+        tests_total++;
+        try {
+            ocl::Reclaimer::setMode(ocl::ReleaseMode::Deferred);
+            const uint64_t released_before = ocl::Reclaimer::getReleasedCount();
+            
+            // Temporaries queue their handles instead of releasing inline
+            const int temporaries = 64;
+            for (int i = 0; i < temporaries; ++i) {
+                ocl::Buffer<float> tmp(ctx, 1024);
+            }
+            
+            // Inputs leave scope while the kernel may still read them; holdUntil
+            // keeps a reference until it completes
+            const size_t N = 1000;
+            std::vector<float> c;
+            ocl::Buffer<float> buf_c(ctx, N);
+            ocl::Program prog = ocl::Program::fromFile(ctx, "vector_add.cl");
+            prog.build(device);
+            ocl::Kernel kernel(prog, "vector_add");
+            ocl::Event done;
+            {
+                ocl::Buffer<float> buf_a(ctx, std::vector<float>(N, 1.0f));
+                ocl::Buffer<float> buf_b(ctx, std::vector<float>(N, 2.0f));
+                kernel.setArgs(buf_a, buf_b, buf_c, static_cast<int>(N));
+                kernel.execute(queue, N);
+                done = queue.enqueueMarker();
+                ocl::Reclaimer::holdUntil(done, buf_a);
+                ocl::Reclaimer::holdUntil(done, buf_b);
+            }
+            buf_c.read(queue, c);
+            done.wait();
+            
+            // The completion callbacks queue the held references
+            const uint64_t expected = released_before + temporaries + 2 + 2;
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            do {
+                ocl::Reclaimer::flush();
+            } while (ocl::Reclaimer::getReleasedCount() < expected && std::chrono::steady_clock::now() < deadline);
+            
+            bool pass = ocl::Reclaimer::getPendingCount() == 0 && ocl::Reclaimer::getReleasedCount() >= expected &&
+                        c.size() == N && c[0] == 3.0f && c[N-1] == 3.0f;
+            ocl::Reclaimer::setMode(ocl::ReleaseMode::Immediate);
+            
+            if (pass) { std::cout << "✓ PASS\n"; tests_passed++; }
+            else { std::cout << "✗ FAIL\n"; }
+        } catch (...) {
+            ocl::Reclaimer::setMode(ocl::ReleaseMode::Immediate);
+            std::cout << "✗ FAIL (exception)\n";
+        }
+        
+        // ================================================================
+        // 13. Pooled Event Tracking
+        // ================================================================
+        std::cout << "[13/15] EventTracker Markers ... ";
+        tests_total++;
+        try {
+            ocl::EventTracker& tracker = ocl::EventTracker::instance();
+            const size_t markers = 3000;  // Spans several 1024-slot chunks
+            auto waitFor = [](const std::function<bool()>& done) {
+                // Statuses lag the device by up to one callback or poll
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+                while (!done() && std::chrono::steady_clock::now() < deadline) {
+                    std::this_thread::yield();
+                }
+                return done();
+            };
+            auto trackMarkers = [&](ocl::TrackingMode mode) {
+                tracker.setMode(mode);
+                std::vector<ocl::TrackedEvent> tracked;
+                tracked.reserve(markers);
+                for (size_t i = 0; i < markers; ++i) {
+                    tracked.push_back(tracker.track(queue.enqueueMarker()));
+                }
+                queue.finish();
+                bool complete = waitFor([&]() {
+                    return std::all_of(tracked.begin(), tracked.end(),
+                                       [](const ocl::TrackedEvent& e) { return e.isComplete(); });
+                });
+                tracked.clear();
+                return complete && waitFor([&]() { return tracker.getActiveCount() == 0; });
+            };
+            
+            bool callback = trackMarkers(ocl::TrackingMode::Callback);
+            const size_t pool = tracker.getPoolSize();
+            bool polling = trackMarkers(ocl::TrackingMode::Polling);
+            tracker.setMode(ocl::TrackingMode::Callback);
+            
+            // The second batch reuses the first one's slots
+            bool reused = pool >= markers && tracker.getPoolSize() == pool;
+            
+            if (callback && polling && reused) { std::cout << "✓ PASS\n"; tests_passed++; }
+            else {
+                std::cout << "✗ FAIL (callback=" << callback << " polling=" << polling << " reused=" << reused << ")\n";
+            }
+        } catch (...) { std::cout << "✗ FAIL (exception)\n"; }
+        
+        // ================================================================
+        // 14. OpenMetrics Export
+        // ================================================================
+        std::cout << "[14/15] Metrics Render ... ";
+        tests_total++;
+        try {
+            ocl::Metrics& metrics = ocl::Metrics::instance();
+            metrics.setKernelTiming(true);
+            
+            const size_t N = 1000;
+            const int launches = 3;
+            std::vector<float> c;
+            ocl::Buffer<float> buf_a(ctx, std::vector<float>(N, 1.0f));
+            ocl::Buffer<float> buf_b(ctx, std::vector<float>(N, 2.0f));
+            ocl::Buffer<float> buf_c(ctx, N);
+            ocl::Program prog = ocl::Program::fromFile(ctx, "vector_add.cl");
+            prog.build(device);
+            ocl::Kernel kernel(prog, "vector_add");
+            kernel.setArgs(buf_a, buf_b, buf_c, static_cast<int>(N));
+            for (int i = 0; i < launches; ++i) {
+                kernel.execute(queue, N);
+            }
+            buf_c.read(queue, c);
+            queue.finish();
+            metrics.setKernelTiming(false);
+            
+            // Value of the sample line starting with `series`
+            auto sampleValue = [](const std::string& text, const std::string& series, double& value) {
+                const size_t pos = text.find("\n" + series + " ");
+                if (pos == std::string::npos) return false;
+                value = std::stod(text.substr(pos + series.size() + 2));
+                return true;
+            };
+            const std::string timing = "ocl_kernel_duration_seconds";
+            const std::string kernel_label = "{kernel=\"vector_add\"}";
+            
+            // Durations arrive through event callbacks
+            std::string text;
+            double count = 0.0;
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            do {
+                text = metrics.render();
+            } while ((!sampleValue(text, timing + "_count" + kernel_label, count) || count < launches) &&
+                     std::chrono::steady_clock::now() < deadline);
+            
+            double launched = 0.0, read_bytes = 0.0, sum = 0.0;
+            bool counters = sampleValue(text, "ocl_kernel_launches_total" + kernel_label, launched) && launched >= launches &&
+                            sampleValue(text, "ocl_transfer_bytes_total{direction=\"device_to_host\"}", read_bytes) &&
+                            read_bytes >= N * sizeof(float);
+            
+            // Buckets are cumulative and end with +Inf, which equals _count
+            const std::string bucket = timing + "_bucket{kernel=\"vector_add\",le=\"";
+            std::istringstream lines(text);
+            std::string line, last;
+            double previous = 0.0;
+            bool cumulative = true;
+            while (std::getline(lines, line)) {
+                if (line.compare(0, bucket.size(), bucket) == 0) {
+                    const double value = std::stod(line.substr(line.rfind(' ') + 1));
+                    cumulative = cumulative && value >= previous;
+                    previous = value;
+                    last = line;
+                }
+            }
+            bool histogram = cumulative && count >= launches && last.find("le=\"+Inf\"") != std::string::npos &&
+                             previous == count && sampleValue(text, timing + "_sum" + kernel_label, sum) && sum > 0.0;
+            
+            bool terminated = text.size() >= 6 && text.compare(text.size() - 6, 6, "# EOF\n") == 0;
+            
+            if (counters && histogram && terminated) { std::cout << "✓ PASS\n"; tests_passed++; }
+            else {
+                std::cout << "✗ FAIL (counters=" << counters << " histogram=" << histogram
+                          << " eof=" << terminated << ")\n";
+            }
+        } catch (...) {
+            ocl::Metrics::instance().setKernelTiming(false);
+            std::cout << "✗ FAIL (exception)\n";
+        }
+        
+        // ================================================================
+        // 15. Single-Flight Kernel Cache
+        // ================================================================
+        std::cout << "[15/15] KernelCache Single Flight ... ";
+        tests_total++;
+        try {
+            ocl::KernelCache cache(ctx);
+            const int threads = 8;
+            
+            // Program builds so far, from the build-time histogram
+            auto buildCount = []() {
+                const std::string text = ocl::Metrics::instance().render();
+                const std::string series = "\nocl_program_build_seconds_count ";
+                const size_t pos = text.find(series);
+                return pos == std::string::npos ? 0.0 : std::stod(text.substr(pos + series.size()));
+            };
+            
+            // Concurrent requests for one key share a single build
+            const double builds_before = buildCount();
+            std::vector<ocl::KernelPool*> pools(threads, nullptr);
+            std::vector<std::thread> workers;
+            for (int t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t]() {
+                    try {
+                        pools[t] = &cache.get(device, "vector_add.cl", "vector_add");
+                    } catch (...) {}
+                });
+            }
+            for (auto& worker : workers) worker.join();
+            bool shared = pools[0] && std::all_of(pools.begin(), pools.end(),
+                                                  [&](ocl::KernelPool* pool) { return pool == pools[0]; });
+            bool single = shared && cache.getProgramCount() == 1 && buildCount() - builds_before == 1.0;
+            
+            // A failed build reaches every waiter and is not cached
+            cache.addSource("scale.cl", "__kernel void scale(__global float* x) { x[get_global_id(0)] *= 2.0f }");
+            std::atomic<int> failures{0};
+            workers.clear();
+            for (int t = 0; t < threads; ++t) {
+                workers.emplace_back([&]() {
+                    try {
+                        cache.getProgram(device, "scale.cl");
+                    } catch (const ocl::Error&) {
+                        failures++;
+                    }
+                });
+            }
+            for (auto& worker : workers) worker.join();
+            bool rethrown = failures == threads && cache.getProgramCount() == 1;
+            
+            // The next request retries with the corrected source
+            cache.addSource("scale.cl", "__kernel void scale(__global float* x) { x[get_global_id(0)] *= 2.0f; }");
+            cache.get(device, "scale.cl", "scale");
+            bool retried = cache.getProgramCount() == 2;
+            
+            if (single && rethrown && retried) { std::cout << "✓ PASS\n"; tests_passed++; }
+            else {
+                std::cout << "✗ FAIL (single=" << single << " rethrown=" << rethrown << " retried=" << retried << ")\n";
+            }
+        } catch (...) { std::cout << "✗ FAIL (exception)\n"; }
+        
         // ================================================================
         // Summary
         // ================================================================
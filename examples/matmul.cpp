@@ -14,7 +14,6 @@ int main() {
         
         // Matrix dimensions
         const size_t M = 1024, N = 1024, K = 1024;
-        const size_t TILE_SIZE = 16;
         
         // Create matrices
         std::vector<float> A(M * K, 1.0f);
@@ -26,21 +25,25 @@ int main() {
         ocl::Buffer<float> buf_B(ctx, B);
         ocl::Buffer<float> buf_C(ctx, M * N);
         
-        // Compile with optimizations
-        ocl::Program prog = ocl::Program::fromFile(ctx, "matmul_tiled.cl");
-        prog.buildOptimized(device);
-        ocl::Kernel kernel(prog, "matmul_tiled");
-        
-        // Calculate optimal 2D work group
-        auto local_2d = ocl::NDRange::getOptimal2D(kernel, device, M, N);
+        // Specialize the tile size at compile time: 32x32 tiles when the
+        // device allows 1024 work-items per group, 16x16 otherwise
+        ocl::Program prog = ocl::Program::fromEmbedded(ctx, "matmul_tiled.cl");
+        size_t tile_size = device.getMaxWorkGroupSize() >= 1024 ? 32 : 16;
+        ocl::Kernel kernel(prog.specializeFor<float>({{"TILE_SIZE", static_cast<int>(tile_size)}},
+                                                     ocl::Program::getOptimizedOptions()), "matmul_tiled");
+        if (kernel.getWorkGroupSize(device) < tile_size * tile_size) {
+            tile_size = 16;
+            kernel = ocl::Kernel(prog.specializeFor<float>({{"TILE_SIZE", 16}}, ocl::Program::getOptimizedOptions()),
+                                 "matmul_tiled");
+        }
         
         std::cout << "Matrix size:  " << M << " x " << K << " x " << K << " x " << N << "\n";
-        std::cout << "Tile size:    " << TILE_SIZE << " x " << TILE_SIZE << "\n";
-        std::cout << "Work group:   [" << local_2d[0] << ", " << local_2d[1] << "]\n";
+        std::cout << "Tile size:    " << tile_size << " x " << tile_size << "\n";
+        std::cout << "Variants:     " << prog.getVariantCount() << "\n";
         
-        // Set arguments and execute
-        kernel.setArgs(buf_A, buf_B, buf_C, static_cast<int>(M), static_cast<int>(N), static_cast<int>(K));
-        kernel.execute2D(queue, M, N, local_2d[0], local_2d[1]);
+        // Set arguments and execute (work group must match the tile)
+        kernel.setArgs(buf_A, buf_B, buf_C, static_cast<int>(M), static_cast<int>(K), static_cast<int>(N));
+        kernel.execute2D(queue, M, N, tile_size, tile_size);
         
         // Read results
         buf_C.read(queue, C);
@@ -0,0 +1,105 @@
+#include <ocl/ocl.hpp>
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+int main() {
+    try {
+        // Initialize
+        auto device = ocl::Device::getDefault();
+        ocl::Context ctx(device);
+        ocl::CommandQueue queue(ctx, device);
+        
+        std::cout << "Quantized int8 Matrix Multiplication (" << device.getName() << ")\n";
+        std::cout << "═══════════════════════════════════════════════════\n";
+        
+        // Matrix dimensions (B is stored N x K, one row per output channel)
+        const size_t M = 256, N = 256, K = 512;
+        
+        std::vector<float> A(M * K), B(N * K);
+        for (size_t i = 0; i < A.size(); ++i) A[i] = static_cast<float>((i * 37) % 101) / 50.0f - 1.0f;
+        for (size_t i = 0; i < B.size(); ++i) B[i] = static_cast<float>((i * 53) % 97) / 96.0f - 0.5f;
+        
+        // Activations: asymmetric per-tensor quantization
+        float a_min = *std::min_element(A.begin(), A.end());
+        float a_max = *std::max_element(A.begin(), A.end());
+        std::vector<float> a_scale = {(a_max - a_min) / 255.0f};
+        std::vector<int> a_zero = {static_cast<int>(std::round(-128.0f - a_min / a_scale[0]))};
+        
+        // Weights: symmetric per-channel quantization
+        std::vector<float> b_scale(N);
+        std::vector<int> b_zero(N, 0);
+        for (size_t n = 0; n < N; ++n) {
+            float max_abs = 0.0f;
+            for (size_t k = 0; k < K; ++k) max_abs = std::max(max_abs, std::abs(B[n * K + k]));
+            b_scale[n] = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+        }
+        
+        // Create buffers
+        ocl::Buffer<float> buf_A(ctx, A);
+        ocl::Buffer<float> buf_B(ctx, B);
+        ocl::Buffer<float> buf_a_scale(ctx, a_scale);
+        ocl::Buffer<int> buf_a_zero(ctx, a_zero);
+        ocl::Buffer<float> buf_b_scale(ctx, b_scale);
+        ocl::Buffer<int> buf_b_zero(ctx, b_zero);
+        ocl::Buffer<cl_char> buf_qA(ctx, M * K);
+        ocl::Buffer<cl_char> buf_qB(ctx, N * K);
+        ocl::Buffer<int> buf_acc(ctx, M * N);
+        ocl::Buffer<float> buf_C(ctx, M * N);
+        
+        // Compile with optimizations
+        ocl::Program prog = ocl::Program::fromEmbedded(ctx, "quantized.cl");
+        prog.buildOptimized(device);
+        ocl::Kernel quantize(prog, "quantize");
+        ocl::Kernel gemm(prog, "gemm_int8");
+        ocl::Kernel dequantize(prog, "dequantize_gemm");
+        
+        std::cout << "Matrix size:  " << M << " x " << K << " x " << N << "\n";
+        std::cout << "Dot product:  " << (device.supportsIntegerDotProduct() ? "cl_khr_integer_dot_product" : "packed char4") << "\n";
+        
+        // Quantize A (per-tensor) and B (per-channel) on the device
+        quantize.setArgs(buf_A, buf_qA, buf_a_scale, buf_a_zero, static_cast<int>(M * K), static_cast<int>(M * K));
+        quantize.execute(queue, M * K);
+        quantize.setArgs(buf_B, buf_qB, buf_b_scale, buf_b_zero, static_cast<int>(K), static_cast<int>(N * K));
+        quantize.execute(queue, N * K);
+        
+        // int8 GEMM into int32 accumulators, then rescale to floats
+        auto local_2d = ocl::NDRange::getOptimal2D(gemm, device, M, N);
+        gemm.setArgs(buf_qA, buf_qB, buf_acc, static_cast<int>(M), static_cast<int>(N), static_cast<int>(K),
+                     a_zero[0], buf_b_zero);
+        gemm.execute2D(queue, M, N, local_2d[0], local_2d[1]);
+        
+        dequantize.setArgs(buf_acc, buf_C, a_scale[0], buf_b_scale, static_cast<int>(M), static_cast<int>(N));
+        dequantize.execute2D(queue, M, N, local_2d[0], local_2d[1]);
+        
+        std::vector<float> C;
+        buf_C.read(queue, C);
+        
+        // Verify against a float reference on a sample of rows
+        float max_error = 0.0f;
+        float max_value = 0.0f;
+        for (size_t m = 0; m < M; m += 17) {
+            for (size_t n = 0; n < N; ++n) {
+                float expected = 0.0f;
+                for (size_t k = 0; k < K; ++k) expected += A[m * K + k] * B[n * K + k];
+                max_error = std::max(max_error, std::abs(C[m * N + n] - expected));
+                max_value = std::max(max_value, std::abs(expected));
+            }
+        }
+        
+        // Quantization error should stay within a couple of percent of the output range
+        bool correct = max_error <= 0.02f * max_value + 1e-3f;
+        
+        std::cout << "Max |C|:      " << max_value << "\n";
+        std::cout << "Max error:    " << max_error << "\n";
+        std::cout << "Result:       " << (correct ? "✓ CORRECT" : "✗ INCORRECT") << "\n";
+        std::cout << "═══════════════════════════════════════════════════\n";
+        
+        return correct ? 0 : 1;
+        
+    } catch (const ocl::Error& e) {
+        std::cerr << "OpenCL error: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -25,14 +25,16 @@ int main() {
         ocl::Buffer<float> buf_input(ctx, data);
         ocl::Buffer<float> buf_output(ctx, NUM_GROUPS);
         
-        // Compile with optimizations
-        ocl::Program prog = ocl::Program::fromFile(ctx, "reduction.cl");
-        prog.buildOptimized(device);
-        ocl::Kernel kernel(prog, "reduce_sum");
+        // Compile with optimizations (sub-group variant when supported)
+        const bool use_subgroups = device.supportsSubgroups();
+        ocl::Program prog = ocl::Program::fromEmbedded(ctx, "reduction.cl");
+        prog.buildOptimized(device, use_subgroups ? "-cl-std=CL2.0" : "");
+        ocl::Kernel kernel(prog, use_subgroups ? "reduce_sum_subgroup" : "reduce_sum");
         
         std::cout << "Problem size: " << N << " elements\n";
         std::cout << "Work group:   " << WORK_GROUP_SIZE << "\n";
         std::cout << "Num groups:   " << NUM_GROUPS << "\n";
+        std::cout << "Variant:      " << (use_subgroups ? "sub-group" : "local-memory tree") << "\n";
         
         // Set arguments (including local memory)
         kernel.setArg(0, buf_input);
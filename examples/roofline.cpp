@@ -0,0 +1,209 @@
+#include <ocl/ocl.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Size sweeps placed on a measured roofline: peak bandwidth comes from a
+// STREAM triad, peak FLOP rate from an FMA chain kernel. Every point is
+// written to CSV with its arithmetic intensity and attainable roof.
+//
+// Usage: roofline [--csv roofline.csv] [--max-mb 256]
+
+struct Point {
+    std::string benchmark;
+    size_t size_bytes;   // Problem size (one operand)
+    double bytes;        // Compulsory memory traffic per run
+    double flops;
+    double median_ms;
+};
+
+void record(std::vector<Point>& points, const std::string& benchmark, size_t size_bytes,
+            const ocl::BenchmarkResult& result) {
+    points.push_back({benchmark, size_bytes, result.bytes, result.flops, result.median_ms});
+    std::cout << std::left << std::setw(14) << benchmark
+              << std::right << std::setw(12) << size_bytes
+              << std::fixed << std::setprecision(4) << std::setw(12) << result.median_ms << " ms"
+              << std::setprecision(1) << std::setw(10) << result.getGBPerSecond() << " GB/s"
+              << std::setw(10) << result.getGFLOPPerSecond() << " GFLOP/s\n";
+}
+
+int main(int argc, char** argv) {
+    std::string csv_path = "roofline.csv";
+    size_t max_mb = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--csv") {
+            csv_path = argv[i + 1];
+        } else if (flag == "--max-mb") {
+            max_mb = std::strtoul(argv[i + 1], nullptr, 10);
+        }
+    }
+    
+    try {
+        auto device = ocl::Device::getDefault();
+        ocl::Context ctx(device);
+        ocl::CommandQueue queue(ctx, device, CL_QUEUE_PROFILING_ENABLE);
+        
+        // Largest operand: one allocation, with room for a few of them
+        size_t max_bytes = static_cast<size_t>(std::min(device.getMaxMemAllocSize(), device.getGlobalMemSize() / 4));
+        if (max_mb > 0) {
+            max_bytes = std::min(max_bytes, max_mb * 1024 * 1024);
+        }
+        const size_t MIN_BYTES = 1024;
+        
+        std::cout << "\nRoofline (" << device.getName() << ")\n";
+        std::cout << "══════════════════════════════════════════════════════════════════\n";
+        std::cout << "Sweep:          1 KB - " << max_bytes / (1024 * 1024) << " MB\n";
+        
+        // Few, quick samples per point: the sweep has many points
+        ocl::BenchmarkConfig config;
+        config.warmup_iterations = 1;
+        config.min_samples = 5;
+        config.max_samples = 100;
+        config.min_time_ms = 10.0;
+        config.max_time_ms = 300.0;
+        config.target_precision = 0.02;
+        config.print = false;
+        ocl::Benchmark bench(config);
+        
+        ocl::Program roof_prog = ocl::Program::buildEmbedded(ctx, device, "roofline.cl");
+        ocl::KernelFunctor<ocl::Buffer<float>, ocl::Buffer<float>, ocl::Buffer<float>, float, int> triad(roof_prog, "stream_triad");
+        ocl::KernelFunctor<ocl::Buffer<float>, float, int> fma_peak(roof_prog, "fma_peak");
+        
+        std::vector<Point> points;
+        
+        // Peak FLOP rate: enough work-items to fill every compute unit
+        const size_t FMA_ITEMS = std::max<size_t>(65536, device.getMaxComputeUnits() * 4096);
+        const int FMA_ITERATIONS = 4096;
+        ocl::Buffer<float> fma_out(ctx, FMA_ITEMS);
+        const auto& fma_result = bench.runEvent("fma_peak", [&]() {
+            return fma_peak(queue, ocl::Range::of1D(FMA_ITEMS), fma_out, 1.0f, FMA_ITERATIONS);
+        }, FMA_ITEMS * sizeof(float), 32.0 * FMA_ITEMS * FMA_ITERATIONS);
+        const double peak_gflops = fma_result.getGFLOPPerSecond();
+        
+        std::cout << "\n" << std::left << std::setw(14) << "Benchmark"
+                  << std::right << std::setw(12) << "Bytes"
+                  << std::setw(15) << "Median"
+                  << std::setw(15) << "Bandwidth"
+                  << std::setw(18) << "Compute" << "\n";
+        std::cout << "──────────────────────────────────────────────────────────────────\n";
+        
+        // Peak bandwidth: best triad rate over the sweep (three operands)
+        double peak_gbps = 0.0;
+        for (size_t size = MIN_BYTES; size <= max_bytes / 3; size *= 2) {
+            const size_t n = size / sizeof(float);
+            ocl::Buffer<float> a(ctx, n), b(ctx, n), c(ctx, n);
+            b.fill(queue, 1.0f);
+            c.fill(queue, 2.0f);
+            const auto& result = bench.runEvent("triad", [&]() {
+                return triad(queue, ocl::Range::of1D(n), a, b, c, 3.0f, static_cast<int>(n));
+            }, 3.0 * size, 2.0 * n);
+            peak_gbps = std::max(peak_gbps, result.getGBPerSecond());
+            record(points, "triad", size, result);
+        }
+        
+        // Transfers and device-side copies
+        for (size_t size = MIN_BYTES; size <= max_bytes / 2; size *= 2) {
+            const size_t n = size / sizeof(float);
+            std::vector<float> host(n, 1.0f), back;
+            ocl::Buffer<float> src(ctx, n), dst(ctx, n);
+            
+            record(points, "write", size, bench.run("write", [&]() {
+                src.write(queue, host);
+            }, size));
+            record(points, "read", size, bench.run("read", [&]() {
+                src.read(queue, back);
+            }, size));
+            record(points, "copy", size, bench.run("copy", [&]() {
+                src.copyTo(queue, dst, n);
+                queue.finish();
+            }, 2.0 * size));
+        }
+        
+        // Reduction: one pass producing per-work-group partial sums
+        ocl::Program red_prog = ocl::Program::buildEmbedded(ctx, device, "reduction.cl");
+        ocl::KernelFunctor<ocl::Buffer<float>, ocl::Buffer<float>, ocl::Local<float>, int> reduce(red_prog, "reduce_sum");
+        const size_t RED_GROUP = std::min<size_t>(256, reduce.getKernel().getWorkGroupSize(device));
+        for (size_t size = MIN_BYTES; size <= max_bytes; size *= 2) {
+            const size_t n = size / sizeof(float);
+            const size_t groups = (n + RED_GROUP - 1) / RED_GROUP;
+            ocl::Buffer<float> input(ctx, n), partials(ctx, groups);
+            input.fill(queue, 1.0f);
+            record(points, "reduce_sum", size, bench.runEvent("reduce_sum", [&]() {
+                return reduce(queue, ocl::Range::of1D(groups * RED_GROUP, RED_GROUP),
+                              input, partials, ocl::Local<float>(RED_GROUP), static_cast<int>(n));
+            }, size + groups * sizeof(float), n));
+        }
+        
+        // Scan: the kernel scans one work-group's worth (n/2 work-items),
+        // so its sweep ends at the work-group and local-memory limits
+        ocl::Program scan_prog = ocl::Program::buildEmbedded(ctx, device, "scan.cl");
+        ocl::KernelFunctor<ocl::Buffer<float>, ocl::Buffer<float>, ocl::Local<float>, int> scan(scan_prog, "scan_inclusive");
+        const size_t scan_max = std::min<size_t>(2 * scan.getKernel().getWorkGroupSize(device),
+                                                 device.getLocalMemSize() / sizeof(float));
+        for (size_t n = 64; n <= scan_max; n *= 2) {
+            const size_t size = n * sizeof(float);
+            ocl::Buffer<float> input(ctx, n), output(ctx, n);
+            input.fill(queue, 1.0f);
+            record(points, "scan", size, bench.runEvent("scan", [&]() {
+                return scan(queue, ocl::Range::of1D(n / 2, n / 2), input, output,
+                            ocl::Local<float>(n), static_cast<int>(n));
+            }, 2.0 * size, 2.0 * n));
+        }
+        
+        // GEMM: square n x n, 16 x 16 tiles
+        ocl::Program gemm_prog = ocl::Program::buildEmbedded(ctx, device, "matmul_tiled.cl");
+        ocl::KernelFunctor<ocl::Buffer<float>, ocl::Buffer<float>, ocl::Buffer<float>, int, int, int> gemm(gemm_prog, "matmul_tiled");
+        for (size_t n = 16; n <= 4096 && n * n * sizeof(float) <= max_bytes / 3; n *= 2) {
+            const size_t size = n * n * sizeof(float);
+            const int dim = static_cast<int>(n);
+            ocl::Buffer<float> A(ctx, n * n), B(ctx, n * n), C(ctx, n * n);
+            A.fill(queue, 1.0f);
+            B.fill(queue, 2.0f);
+            record(points, "gemm", size, bench.runEvent("gemm", [&]() {
+                return gemm(queue, ocl::Range::of2D(n, n, 16, 16), A, B, C, dim, dim, dim);
+            }, 3.0 * size, 2.0 * n * n * n));
+        }
+        
+        std::cout << "\nPeak bandwidth: " << std::fixed << std::setprecision(1) << peak_gbps << " GB/s (stream_triad)\n";
+        std::cout << "Peak compute:   " << peak_gflops << " GFLOP/s (fma_peak)\n";
+        std::cout << "Ridge point:    " << std::setprecision(2) << peak_gflops / peak_gbps << " FLOP/byte\n";
+        
+        // One row per point. attainable = min(peak compute, intensity x peak
+        // bandwidth); efficiency is measured / attainable (GB/s for data
+        // movement without FLOPs)
+        std::ofstream csv(csv_path);
+        if (!csv.is_open()) {
+            std::cerr << "Cannot write " << csv_path << "\n";
+            return 1;
+        }
+        csv << "benchmark,size_bytes,bytes,flops,median_ms,gb_per_s,gflop_per_s,intensity,"
+               "peak_gb_per_s,peak_gflop_per_s,attainable_gflop_per_s,efficiency\n";
+        csv << std::setprecision(9) << std::defaultfloat;
+        for (const auto& p : points) {
+            const double seconds = p.median_ms / 1000.0;
+            const double gbps = p.bytes / seconds / 1e9;
+            const double gflops = p.flops / seconds / 1e9;
+            const double intensity = p.bytes > 0 ? p.flops / p.bytes : 0.0;
+            const double attainable = std::min(peak_gflops, intensity * peak_gbps);
+            const double efficiency = p.flops > 0 ? gflops / attainable : gbps / peak_gbps;
+            csv << p.benchmark << ',' << p.size_bytes << ',' << p.bytes << ',' << p.flops << ','
+                << p.median_ms << ',' << gbps << ',' << gflops << ',' << intensity << ','
+                << peak_gbps << ',' << peak_gflops << ',' << attainable << ',' << efficiency << "\n";
+        }
+        
+        std::cout << "\n══════════════════════════════════════════════════════════════════\n";
+        std::cout << points.size() << " points written to " << csv_path << "\n";
+        std::cout << "══════════════════════════════════════════════════════════════════\n\n";
+        
+    } catch (const ocl::Error& e) {
+        std::cerr << "OpenCL error: " << e.what() << "\n";
+        return 1;
+    }
+    
+    return 0;
+}
@@ -25,13 +25,15 @@ int main() {
         ocl::Buffer<float> buf_input(ctx, input);
         ocl::Buffer<float> buf_output(ctx, N);
         
-        // Compile with optimizations
-        ocl::Program prog = ocl::Program::fromFile(ctx, "scan.cl");
-        prog.buildOptimized(device);
-        ocl::Kernel kernel(prog, "scan_inclusive");
+        // Compile with optimizations (sub-group variant when supported)
+        const bool use_subgroups = device.supportsSubgroups();
+        ocl::Program prog = ocl::Program::fromEmbedded(ctx, "scan.cl");
+        prog.buildOptimized(device, use_subgroups ? "-cl-std=CL2.0" : "");
+        ocl::Kernel kernel(prog, use_subgroups ? "scan_subgroup" : "scan_inclusive");
         
         std::cout << "Problem size: " << N << " elements\n";
         std::cout << "Work group:   " << WORK_GROUP_SIZE << "\n";
+        std::cout << "Variant:      " << (use_subgroups ? "sub-group" : "work-efficient tree") << "\n";
         
         // Set arguments (including local memory)
         kernel.setArg(0, buf_input);
@@ -21,21 +21,25 @@ int main() {
         ocl::Buffer<float> buf_b(ctx, b);
         ocl::Buffer<float> buf_c(ctx, N);
         
-        // Compile with optimizations
-        ocl::Program prog = ocl::Program::fromFile(ctx, "vector_add.cl");
-        prog.buildOptimized(device);
-        ocl::Kernel kernel(prog, "vector_add");
+        // Compile with optimizations (uses embedded SPIR-V or a precompiled
+        // binary when available, the embedded source otherwise).
+        // -cl-kernel-arg-info lets the functor check argument types.
+        ocl::Program prog = ocl::Program::buildEmbedded(ctx, device, "vector_add.cl",
+                                                        ocl::Program::getOptimizedOptions() + " -cl-kernel-arg-info");
+        
+        // Typed kernel: signature is validated once, here
+        ocl::KernelFunctor<ocl::Buffer<float>, ocl::Buffer<float>, ocl::Buffer<float>, int> vector_add(prog, "vector_add");
         
         // Calculate optimal work group size
-        size_t local = ocl::NDRange::getOptimal1D(kernel, device, N);
+        size_t local = ocl::NDRange::getOptimal1D(vector_add.getKernel(), device, N);
         size_t global = ocl::NDRange::getPaddedGlobalSize(N, local);
         
         std::cout << "Problem size: " << N << " elements\n";
         std::cout << "Work group:   " << local << " (global: " << global << ")\n";
         
-        // Execute with variadic args and optimal sizing
-        kernel.setArgs(buf_a, buf_b, buf_c, static_cast<int>(N));
-        kernel.execute(queue, global, local);
+        // Execute with typed args and optimal sizing
+        ocl::Event done = vector_add(queue, ocl::Range::of1D(global, local), buf_a, buf_b, buf_c, static_cast<int>(N));
+        done.wait();
         
         // Read results
         buf_c.read(queue, c);
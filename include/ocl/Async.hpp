@@ -0,0 +1,134 @@
+#pragma once
+
+#include <ocl/Errors.hpp>
+#include <ocl/Event.hpp>
+#include <ocl/Executor.hpp>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+#include <coroutine>
+#define OCL_HAS_COROUTINES 1
+#endif
+
+namespace ocl {
+
+// Forward declaration
+class Context;
+
+// ============================================================================
+// Async - non-blocking completion of OpenCL events
+// ============================================================================
+
+// Call `callback(status)` once `event` completes (status is CL_COMPLETE or a
+// negative error code). Driven by clSetEventCallback - nothing polls or
+// blocks. The callback runs on `executor`, or directly on the OpenCL
+// callback thread when executor is nullptr.
+void onComplete(const Event& event, std::function<void(cl_int)> callback, Executor* executor = nullptr);
+
+// Future that becomes ready when `event` completes (holds ocl::Error on failure)
+// Usage: std::future<void> done = ocl::toFuture(kernel_event);
+std::future<void> toFuture(const Event& event);
+
+// Sets a promise from a callable's result (void and non-void)
+template<typename R>
+struct PromiseSetter {
+    template<typename F>
+    static void set(std::promise<R>& promise, F& f) { promise.set_value(f()); }
+};
+
+template<>
+struct PromiseSetter<void> {
+    template<typename F>
+    static void set(std::promise<void>& promise, F& f) { f(); promise.set_value(); }
+};
+
+// Run `f` on `executor` after `event` completes; the future holds its result
+// (or ocl::Error if the event failed, or whatever `f` throws)
+// Usage: auto sum = ocl::then(read_event, pool, [&] { return total(host); });
+template<typename F>
+auto then(const Event& event, Executor& executor, F f) -> std::future<decltype(f())> {
+    using R = decltype(f());
+    auto promise = std::make_shared<std::promise<R>>();
+    std::future<R> future = promise->get_future();
+    
+    onComplete(event, [promise, f = std::move(f)](cl_int status) mutable {
+        try {
+            if (status < 0) {
+                throw Error(status, "waiting for event");
+            }
+            PromiseSetter<R>::set(*promise, f);
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    }, &executor);
+    return future;
+}
+
+// ============================================================================
+// Host tasks - CPU work as a node in the device dependency graph
+// ============================================================================
+
+// Run `task` on `executor` once every event in `after` has completed, and
+// return a user event that completes when the task returns. Device commands
+// can wait on it (wait lists, CommandQueue::enqueueBarrier) without a host
+// thread blocking in between. If a dependency fails or the task throws, the
+// returned event fails with CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST.
+// Usage:
+//   Event host = ocl::hostTask(ctx, pool, ocl::waitList(read_done), [&] { postprocess(data); });
+//   queue.enqueueBarrier(ocl::waitList(host));  // Later commands run after the host task
+Event hostTask(const Context& context, Executor& executor, const std::vector<Event>& after,
+               std::function<void()> task);
+
+#ifdef OCL_HAS_COROUTINES
+
+// ============================================================================
+// EventAwaiter - co_await support (C++20)
+// ============================================================================
+
+// Suspends the coroutine until the event completes and resumes it on the
+// executor, so thousands of jobs can be in flight on a few threads.
+// Usage: co_await ocl::resumeOn(kernel_event, pool);  or  co_await event;
+class EventAwaiter {
+public:
+    EventAwaiter(const Event& event, Executor& executor)
+        : event_(event.retain()), executor_(&executor), status_(CL_COMPLETE) {}
+    
+    bool await_ready() const { return event_.isComplete(); }
+    
+    void await_suspend(std::coroutine_handle<> handle) {
+        onComplete(event_, [this, handle](cl_int status) {
+            status_ = status;
+            handle.resume();
+        }, executor_);
+    }
+    
+    void await_resume() const {
+        if (status_ < 0) {
+            throw Error(status_, "awaiting event");
+        }
+    }
+    
+private:
+    Event event_;
+    Executor* executor_;
+    cl_int status_;
+};
+
+inline EventAwaiter resumeOn(const Event& event, Executor& executor) {
+    return EventAwaiter(event, executor);
+}
+
+// Resumes on defaultExecutor()
+inline EventAwaiter operator co_await(const Event& event) {
+    return EventAwaiter(event, defaultExecutor());
+}
+
+#endif // OCL_HAS_COROUTINES
+
+} // namespace ocl
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <ocl/Errors.hpp>
+#include <ocl/Event.hpp>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ocl {
+
+// ============================================================================
+// Benchmark - statistically robust timing with JSON/CSV output
+// ============================================================================
+
+struct BenchmarkConfig {
+    size_t warmup_iterations = 3;   // Untimed runs before sampling
+    size_t min_samples = 10;
+    size_t max_samples = 1000;
+    double min_time_ms = 100.0;     // Keep sampling at least this long...
+    double max_time_ms = 5000.0;    // ...but never longer than this
+    double target_precision = 0.01; // Stop once the 95% CI of the median is within ±1%
+    double outlier_threshold = 5.0; // Reject samples this many (scaled) MADs from the median
+    bool print = true;              // Print each result as a table row
+};
+
+struct BenchmarkResult {
+    std::string name;
+    bool device_timing = false;     // Event profiling (true) or host wall clock
+    size_t samples = 0;             // Samples kept after outlier rejection
+    size_t outliers = 0;
+    
+    // Per-iteration time statistics, in milliseconds
+    double median_ms = 0.0;
+    double mad_ms = 0.0;            // Median absolute deviation (unscaled)
+    double mean_ms = 0.0;
+    double stddev_ms = 0.0;
+    double min_ms = 0.0;
+    double max_ms = 0.0;
+    double ci_low_ms = 0.0;         // 95% confidence interval of the median
+    double ci_high_ms = 0.0;
+    
+    // Work per iteration, for derived rates (0 = not reported)
+    double bytes = 0.0;
+    double flops = 0.0;
+    
+    double getGBPerSecond() const { return bytes > 0 && median_ms > 0 ? bytes / (median_ms * 1e6) : 0.0; }
+    double getGFLOPPerSecond() const { return flops > 0 && median_ms > 0 ? flops / (median_ms * 1e6) : 0.0; }
+};
+
+// Outcome of comparing one benchmark across two runs
+enum class BenchmarkChange { Unchanged, Improvement, Regression };
+
+struct BenchmarkComparison {
+    std::string name;
+    double baseline_ms = 0.0;
+    double candidate_ms = 0.0;
+    double change_pct = 0.0;        // Candidate vs baseline median (+ = slower)
+    double z_score = 0.0;           // Median difference over its standard error
+    BenchmarkChange change = BenchmarkChange::Unchanged;
+};
+
+// Usage:
+//   Benchmark bench;
+//   bench.run("fill", [&] { buf.fill(queue, 0.0f); }, N * sizeof(float));
+//   bench.runEvent("vector_add", [&] { return add(queue, range, a, b, c, n); }, 3 * N * 4, N);
+//   bench.writeJSON(file);
+class Benchmark {
+public:
+    explicit Benchmark(BenchmarkConfig config = BenchmarkConfig());
+    
+    // Host-timed: `func` must finish its work before returning
+    const BenchmarkResult& run(const std::string& name, const std::function<void()>& func,
+                               double bytes = 0.0, double flops = 0.0);
+    
+    // Device-timed: `func` enqueues work and returns the event of the
+    // command to time. Uses CL_PROFILING_COMMAND_START/END when the queue
+    // has CL_QUEUE_PROFILING_ENABLE, and host time up to completion otherwise.
+    const BenchmarkResult& runEvent(const std::string& name, const std::function<Event()>& func,
+                                    double bytes = 0.0, double flops = 0.0);
+    
+    // Compute statistics for raw per-iteration samples (in milliseconds)
+    static BenchmarkResult summarize(const std::string& name, std::vector<double> samples_ms,
+                                     double outlier_threshold = 5.0);
+    
+    // Compare medians using each result's recorded spread. A change is
+    // flagged only if it is statistically significant (|z| >= z_threshold)
+    // and at least min_change_pct large.
+    static BenchmarkComparison compare(const BenchmarkResult& baseline, const BenchmarkResult& candidate,
+                                       double z_threshold = 3.0, double min_change_pct = 2.0);
+    
+    // Key/value context written with the results (device, driver, ...)
+    void setMetadata(const std::string& key, const std::string& value) { metadata_[key] = value; }
+    const std::map<std::string, std::string>& getMetadata() const { return metadata_; }
+    
+    const std::vector<BenchmarkResult>& getResults() const { return results_; }
+    // Applies to later runs (e.g. fewer samples for slow operations)
+    void setConfig(const BenchmarkConfig& config) { config_ = config; }
+    const BenchmarkConfig& getConfig() const { return config_; }
+    
+    // Output
+    static void printHeader(std::ostream& out);
+    static void printResult(std::ostream& out, const BenchmarkResult& result);
+    void writeJSON(std::ostream& out) const;
+    void writeCSV(std::ostream& out) const;
+    bool writeJSON(const std::string& filepath) const;
+    bool writeCSV(const std::string& filepath) const;
+    
+    // Load metadata and results written by writeJSON (replaces current ones)
+    bool readJSON(const std::string& filepath);
+    
+private:
+    // Sample until the stopping rule is met; `sample` returns one timing
+    // in ms and whether it came from device profiling
+    const BenchmarkResult& measure(const std::string& name, const std::function<double(bool&)>& sample,
+                                   double bytes, double flops);
+    
+    BenchmarkConfig config_;
+    std::map<std::string, std::string> metadata_;
+    std::vector<BenchmarkResult> results_;
+};
+
+} // namespace ocl
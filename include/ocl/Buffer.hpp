@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ocl/Errors.hpp>
+#include <cstdint>
 #include <vector>
 
 namespace ocl {
@@ -9,6 +10,16 @@ namespace ocl {
 class Context;
 class CommandQueue;
 
+// Telemetry hooks (defined in Metrics.cpp)
+namespace detail {
+    enum class TransferDirection { HostToDevice, DeviceToHost, DeviceToDevice };
+    void recordTransfer(TransferDirection direction, size_t bytes);
+    void recordDeviceMemory(int64_t delta);
+    
+    // Inline or deferred per Reclaimer's mode (defined in Reclaimer.cpp)
+    void releaseMemObject(cl_mem mem);
+}
+
 // ============================================================================
 // Templated Buffer - Type-safe OpenCL memory buffer
 // ============================================================================
@@ -30,7 +41,8 @@ public:
     // Destructor
     ~Buffer() {
         if (buffer_) {
-            clReleaseMemObject(buffer_);
+            detail::releaseMemObject(buffer_);
+            detail::recordDeviceMemory(-static_cast<int64_t>(capacityBytes()));
         }
     }
     
@@ -48,7 +60,8 @@ public:
     Buffer& operator=(Buffer&& other) noexcept {
         if (this != &other) {
             if (buffer_) {
-                clReleaseMemObject(buffer_);
+                detail::releaseMemObject(buffer_);
+                detail::recordDeviceMemory(-static_cast<int64_t>(capacityBytes()));
             }
             buffer_ = other.buffer_;
             size_ = other.size_;
@@ -145,6 +158,7 @@ Buffer<T>::Buffer(const Context& context, size_t count, cl_mem_flags flags) : si
                             nullptr, 
                             &err);
     checkError(err, "creating buffer");
+    detail::recordDeviceMemory(static_cast<int64_t>(capacityBytes()));
 }
 
 template<typename T>
@@ -157,6 +171,8 @@ Buffer<T>::Buffer(const Context& context, const std::vector<T>& data, cl_mem_fla
                             const_cast<T*>(data.data()),  // clCreateBuffer needs non-const
                             &err);
     checkError(err, "creating buffer with data");
+    detail::recordDeviceMemory(static_cast<int64_t>(capacityBytes()));
+    detail::recordTransfer(detail::TransferDirection::HostToDevice, capacityBytes());
 }
 
 template<typename T>
@@ -176,6 +192,7 @@ void Buffer<T>::write(const CommandQueue& queue, const std::vector<T>& data, boo
                                      nullptr, 
                                      nullptr);
     checkError(err, "writing buffer");
+    detail::recordTransfer(detail::TransferDirection::HostToDevice, data.size() * sizeof(T));
 }
 
 // Async write
@@ -194,6 +211,7 @@ void Buffer<T>::writeAsync(const CommandQueue& queue, const std::vector<T>& data
                                      data.data(), 
                                      0, nullptr, &event);  // Use address directly
     checkError(err, "writing buffer async");
+    detail::recordTransfer(detail::TransferDirection::HostToDevice, data.size() * sizeof(T));
 }
 
 template<typename T>
@@ -210,6 +228,7 @@ void Buffer<T>::write(const CommandQueue& queue, const std::vector<T>& data, siz
                                      data.data(), 
                                      0, nullptr, nullptr);
     checkError(err, "writing buffer with offset");
+    detail::recordTransfer(detail::TransferDirection::HostToDevice, data.size() * sizeof(T));
 }
 
 template<typename T>
@@ -226,6 +245,7 @@ void Buffer<T>::write(const CommandQueue& queue, const T* data, size_t count, si
                                      data, 
                                      0, nullptr, nullptr);
     checkError(err, "writing buffer from pointer");
+    detail::recordTransfer(detail::TransferDirection::HostToDevice, count * sizeof(T));
 }
 
 template<typename T>
@@ -240,6 +260,7 @@ void Buffer<T>::read(const CommandQueue& queue, std::vector<T>& data, bool block
                                     data.data(), 
                                     0, nullptr, nullptr);
     checkError(err, "reading buffer");
+    detail::recordTransfer(detail::TransferDirection::DeviceToHost, size_ * sizeof(T));
 }
 
 // Async read
@@ -255,6 +276,7 @@ void Buffer<T>::readAsync(const CommandQueue& queue, std::vector<T>& data, cl_ev
                                     data.data(), 
                                     0, nullptr, &event);  // Use address directly
     checkError(err, "reading buffer async");
+    detail::recordTransfer(detail::TransferDirection::DeviceToHost, size_ * sizeof(T));
 }
 
 template<typename T>
@@ -273,6 +295,7 @@ void Buffer<T>::read(const CommandQueue& queue, std::vector<T>& data, size_t cou
                                     data.data(), 
                                     0, nullptr, nullptr);
     checkError(err, "reading buffer with offset");
+    detail::recordTransfer(detail::TransferDirection::DeviceToHost, count * sizeof(T));
 }
 
 template<typename T>
@@ -289,6 +312,7 @@ void Buffer<T>::read(const CommandQueue& queue, T* data, size_t count, size_t of
                                     data, 
                                     0, nullptr, nullptr);
     checkError(err, "reading buffer to pointer");
+    detail::recordTransfer(detail::TransferDirection::DeviceToHost, count * sizeof(T));
 }
 
 template<typename T>
@@ -315,6 +339,7 @@ void Buffer<T>::copyFrom(const CommandQueue& queue, const Buffer<T>& src, size_t
                                     count * sizeof(T),
                                     0, nullptr, nullptr);
     checkError(err, "copying buffer");
+    detail::recordTransfer(detail::TransferDirection::DeviceToDevice, count * sizeof(T));
     
     if (blocking) {
         err = clFinish(detail::getQueueHandle(queue));
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <ocl/Errors.hpp>
+#include <ocl/Event.hpp>
+#include <vector>
 
 namespace ocl {
 
@@ -32,6 +34,14 @@ public:
     void finish();
     void flush();
     
+    // Event that completes when the listed events (or, if none, all
+    // previously enqueued commands) have completed
+    Event enqueueMarker(const std::vector<Event>& wait_for = {});
+    
+    // Later commands wait for the listed events (or all previous commands);
+    // use with events from other queues to order work across queues
+    void enqueueBarrier(const std::vector<Event>& wait_for = {});
+    
     // Get underlying queue
     cl_command_queue get() const { return queue_; }
     
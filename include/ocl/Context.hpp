@@ -17,6 +17,7 @@ public:
     Context();
     explicit Context(const Device& device);
     explicit Context(const std::vector<Device>& devices);
+    explicit Context(cl_context context);  // Takes ownership
     
     ~Context();
     
@@ -29,17 +29,42 @@ public:
     std::string getName() const;
     std::string getVendor() const;
     std::string getVersion() const;
+    std::string getDriverVersion() const;
+    cl_uint getVersionNumber() const;  // e.g. 120, 200, 300 (same scheme as CL_TARGET_OPENCL_VERSION)
     cl_device_type getType() const;
     cl_ulong getGlobalMemSize() const;
     cl_ulong getLocalMemSize() const;
+    cl_ulong getMaxMemAllocSize() const;  // Largest single buffer
     cl_uint getMaxComputeUnits() const;
+    cl_uint getMaxClockFrequency() const;  // In MHz
     cl_uint getMaxWorkGroupSize() const;
+    std::string getExtensions() const;
+    std::string getILVersion() const;     // e.g. "SPIR-V_1.0 SPIR-V_1.2" ("" if IL is unsupported)
+    cl_uint getMemBaseAddrAlign() const;  // In bits
+    
+    // Preferred native vector widths (CL_DEVICE_PREFERRED_VECTOR_WIDTH_*)
+    cl_uint getPreferredVectorWidthChar() const;
+    cl_uint getPreferredVectorWidthInt() const;
+    cl_uint getPreferredVectorWidthFloat() const;
+    cl_uint getPreferredVectorWidthDouble() const;  // 0 if fp64 is unsupported
+    
+    // Check for an extension by exact name (e.g. "cl_khr_fp64")
+    bool hasExtension(const std::string& name) const;
     
     // Device type predicates
     bool isGPU() const;
     bool isCPU() const;
     bool isAccelerator() const;
     
+    // Capability predicates
+    bool supportsIntegerDotProduct() const;  // cl_khr_integer_dot_product
+    bool supportsSubgroups() const;          // cl_khr_subgroups on an OpenCL 2.0+ device
+    bool supportsIL() const;                 // SPIR-V via Program::fromIL
+    bool supportsFP64() const;               // cl_khr_fp64 or a core double config
+    
+    // Platform the device belongs to
+    Platform getPlatform() const;
+    
     // Get underlying device ID
     cl_device_id id() const { return id_; }
     
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <ocl/Errors.hpp>
+#include <ocl/Device.hpp>
+#include <ocl/Program.hpp>
+#include <ocl/Kernel.hpp>
+#include <ocl/Types.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace ocl {
+
+// Forward declarations
+class Context;
+class CommandQueue;
+template<typename T> class Buffer;
+
+// ============================================================================
+// ElementWise - generated, vectorized element-wise kernel (out = f(a, b))
+// ============================================================================
+
+class ElementWise {
+public:
+    // Build a kernel computing `expression` over inputs a and b
+    // Usage: ElementWise add(ctx, device, "a + b");
+    // vector_width = 0 uses the device's preferred width for `type`
+    ElementWise(const Context& context, const Device& device, const std::string& expression,
+                const std::string& type = "float", cl_uint vector_width = 0);
+    
+    // Run over the first `count` elements (0 = whole output buffer). T must
+    // be the element type the kernel was generated for, and every buffer
+    // must hold at least `count` elements (std::invalid_argument otherwise).
+    template<typename T>
+    void execute(const CommandQueue& queue, const Buffer<T>& a, const Buffer<T>& b, Buffer<T>& out, size_t count = 0) {
+        if (typeName<T>() != type_) {
+            throw std::invalid_argument("ElementWise kernel was generated for " + type_ + ", not " + typeName<T>());
+        }
+        if (count == 0) {
+            count = out.size();
+        }
+        if (count > std::min({a.size(), b.size(), out.size()})) {
+            throw std::invalid_argument("ElementWise count " + std::to_string(count) + " exceeds a buffer's size");
+        }
+        executeImpl(queue, a.get(), b.get(), out.get(), count, sizeof(T));
+    }
+    
+    // Generate the OpenCL source for an expression (vector_width in 1, 2, 4, 8, 16)
+    static std::string generateSource(const std::string& expression, const std::string& type, cl_uint vector_width);
+    
+    // Vector width the kernel was generated for
+    cl_uint getVectorWidth() const { return vector_width_; }
+    
+    // True if the buffers allow whole-vector loads (otherwise vloadn is used)
+    bool isAligned(cl_mem a, cl_mem b, cl_mem out, size_t element_size) const;
+    
+private:
+    void executeImpl(const CommandQueue& queue, cl_mem a, cl_mem b, cl_mem out, size_t count, size_t element_size);
+    
+    std::string type_;
+    cl_uint vector_width_;
+    size_t base_align_bytes_;
+    size_t local_size_;
+    Program program_;
+    Kernel aligned_;
+    Kernel unaligned_;
+};
+
+} // namespace ocl
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <ocl/Errors.hpp>
+#include <string>
+#include <vector>
+
+namespace ocl {
+
+// ============================================================================
+// Embedded files - kernel sources/binaries compiled into the executable
+// (generated by the ocl_embed_kernels() CMake function)
+// ============================================================================
+
+struct EmbeddedFile {
+    enum Kind { Source, Binary, IL };
+    
+    const char* name;            // File name, e.g. "vector_add.cl"
+    Kind kind;
+    const char* device;          // CL_DEVICE_NAME a binary targets ("" for sources)
+    const unsigned char* data;   // Sources are null-terminated
+    size_t size;                 // In bytes, excluding the terminator
+    
+    std::string str() const { return std::string(reinterpret_cast<const char*>(data), size); }
+};
+
+// Register a table of embedded files (tables must outlive the process)
+void registerEmbeddedFiles(const EmbeddedFile* files, size_t count);
+
+// Registers a table during static initialization
+struct EmbeddedRegistration {
+    EmbeddedRegistration(const EmbeddedFile* files, size_t count) {
+        registerEmbeddedFiles(files, count);
+    }
+};
+
+// Find an embedded file (nullptr if not found)
+const EmbeddedFile* findEmbedded(const std::string& name, EmbeddedFile::Kind kind = EmbeddedFile::Source,
+                                 const std::string& device = "");
+
+// Names of all embedded sources
+std::vector<std::string> listEmbedded();
+
+} // namespace ocl
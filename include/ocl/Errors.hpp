@@ -1,7 +1,12 @@
 #pragma once
 
+// Override with -DOCL_TARGET_OPENCL_VERSION=... in CMake (e.g. 210 enables
+// clCreateProgramWithIL)
+#ifndef CL_TARGET_OPENCL_VERSION
 #define CL_TARGET_OPENCL_VERSION 200
+#endif
 #include <CL/cl.h>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
 
@@ -33,6 +38,13 @@ inline void checkError(cl_int err, const std::string& operation) {
     }
 }
 
+// String literals bind here, so the success path never builds a std::string
+inline void checkError(cl_int err, const char* operation) {
+    if (err != CL_SUCCESS) {
+        throw Error(err, operation);
+    }
+}
+
 // ============================================================================
 // Utility Functions
 // ============================================================================
@@ -40,6 +52,15 @@ inline void checkError(cl_int err, const std::string& operation) {
 // Read entire file into a string (defined in Errors.cpp)
 std::string readFile(const std::string& filepath);
 
+namespace detail {
+    // readFile that returns false instead of throwing when the file cannot
+    // be opened (include search)
+    bool tryReadFile(const std::string& filepath, std::string& contents);
+    
+    // 64-bit FNV-1a, for source and cache-key hashes
+    uint64_t fnv1a(const std::string& data);
+}
+
 // Get OpenCL info string (helper for Platform and Device)
 std::string getInfoString(cl_platform_id platform, cl_platform_info param);
 std::string getInfoString(cl_device_id device, cl_device_info param);
@@ -5,6 +5,9 @@
 
 namespace ocl {
 
+// Forward declaration
+class Context;
+
 // ============================================================================
 // Event - manages OpenCL event with RAII
 // ============================================================================
@@ -24,6 +27,18 @@ public:
     Event(Event&& other) noexcept;
     Event& operator=(Event&& other) noexcept;
     
+    // User event, completed from the host with setUserStatus()
+    // Usage: Event gate = Event::createUser(ctx); ... gate.setUserStatus(CL_COMPLETE);
+    static Event createUser(const Context& context);
+    
+    // Complete a user event: CL_COMPLETE, or a negative error code to fail
+    // the commands that wait on it
+    void setUserStatus(cl_int status);
+    
+    // Another reference to the same event (clRetainEvent), e.g. to pass it
+    // as a dependency while keeping this one
+    Event retain() const;
+    
     // Wait for event to complete
     void wait();
     
@@ -53,5 +68,17 @@ private:
 // Wait for multiple events
 void waitForEvents(const std::vector<Event>& events);
 
+// Dependency list holding a new reference to each event (Event is move-only,
+// so a braced list of events cannot be copied into a vector)
+// Usage: queue.enqueueBarrier(ocl::waitList(upload, host_done));
+template<typename... Events>
+std::vector<Event> waitList(const Events&... events) {
+    std::vector<Event> list;
+    list.reserve(sizeof...(events));
+    using expand = int[];
+    (void)expand{0, (list.push_back(events.retain()), 0)...};
+    return list;
+}
+
 } // namespace ocl
 
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <ocl/Errors.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace ocl {
+
+// Forward declaration
+class Event;
+
+// ============================================================================
+// EventTracker - completion status of many events without per-query calls
+// ============================================================================
+
+// Usage:
+//   ocl::TrackedEvent done = ocl::EventTracker::instance().track(queue.enqueueMarker());
+//   while (!done.isComplete()) { ... }   // An atomic load, no clGetEventInfo
+//
+// Each tracked event gets a slot from a pool (allocated in chunks and
+// recycled through a lock-free free list). The slot's status is written
+// either by the driver's callback thread (Callback mode, one
+// clSetEventCallback per event) or by one background thread polling all
+// pending events in a batch (Polling mode, for drivers with slow or
+// serialized callbacks). TrackedEvent is a pointer into the pool, so
+// tracking allocates nothing once the pool has grown.
+
+enum class TrackingMode {
+    Callback,  // Driver callbacks mark completion (default)
+    Polling    // A background thread polls pending events every interval
+};
+
+namespace detail {
+    // One pooled slot. A slot is referenced by its TrackedEvent and by the
+    // callback or poller until completion; the last reference frees it.
+    struct EventSlot {
+        std::atomic<cl_int> status{CL_COMPLETE};  // Last seen execution status
+        std::atomic<uint32_t> refs{0};
+        std::atomic<bool> watched{false};         // Poller still holds a reference
+        std::atomic<uint32_t> next_free{0};       // Free list link (index + 1, 0 = end)
+        cl_event event = nullptr;
+    };
+}
+
+// Handle to a tracked event (move-only; frees its slot when destroyed)
+class TrackedEvent {
+public:
+    TrackedEvent() : slot_(nullptr), index_(0) {}
+    ~TrackedEvent();
+    
+    // Disable copying
+    TrackedEvent(const TrackedEvent&) = delete;
+    TrackedEvent& operator=(const TrackedEvent&) = delete;
+    
+    // Enable moving
+    TrackedEvent(TrackedEvent&& other) noexcept : slot_(other.slot_), index_(other.index_) {
+        other.slot_ = nullptr;
+    }
+    TrackedEvent& operator=(TrackedEvent&& other) noexcept;
+    
+    // Memory loads; the status lags the device by up to one callback or poll
+    cl_int getStatus() const {
+        return slot_ ? slot_->status.load(std::memory_order_acquire) : CL_INVALID_EVENT;
+    }
+    bool isComplete() const { return getStatus() == CL_COMPLETE; }
+    bool isFinished() const { return getStatus() <= CL_COMPLETE; }  // Complete or failed
+    
+    // Block until complete (clWaitForEvents), updating the status
+    void wait();
+    
+    // Underlying event (owned by the tracker while this handle lives)
+    cl_event get() const { return slot_ ? slot_->event : nullptr; }
+    
+    bool isValid() const { return slot_ != nullptr; }
+    
+private:
+    friend class EventTracker;
+    TrackedEvent(detail::EventSlot* slot, uint32_t index) : slot_(slot), index_(index) {}
+    
+    detail::EventSlot* slot_;
+    uint32_t index_;
+};
+
+class EventTracker {
+public:
+    static EventTracker& instance();
+    
+    ~EventTracker();
+    
+    // Applies to events tracked afterwards; tracked events finish in the
+    // mode they started in
+    void setMode(TrackingMode mode, std::chrono::microseconds poll_interval = std::chrono::microseconds(100));
+    TrackingMode getMode() const { return mode_.load(std::memory_order_relaxed); }
+    
+    // Register an event: the first takes a new reference, the second takes
+    // over the event's own
+    TrackedEvent track(const Event& event);
+    TrackedEvent track(Event&& event);
+    
+    // Slots in use (tracked events plus completions not yet delivered)
+    size_t getActiveCount() const { return active_.load(std::memory_order_relaxed); }
+    
+    // Slots allocated so far (the pool never shrinks)
+    size_t getPoolSize() const { return pool_size_.load(std::memory_order_acquire); }
+    
+private:
+    friend class TrackedEvent;
+    
+    static const uint32_t kChunkSize = 1024;
+    static const uint32_t kMaxChunks = 4096;
+    
+    EventTracker();
+    
+    TrackedEvent trackHandle(cl_event event);
+    detail::EventSlot& slot(uint32_t index) const {
+        return chunks_[index / kChunkSize].load(std::memory_order_acquire)[index % kChunkSize];
+    }
+    uint32_t allocateSlot();
+    void pushFree(uint32_t index);
+    void dropRef(uint32_t index);
+    void poll();
+    
+    static void CL_CALLBACK onComplete(cl_event event, cl_int status, void* user_data);
+    
+    std::atomic<TrackingMode> mode_;
+    std::chrono::microseconds poll_interval_;  // Guarded by mutex_
+    
+    std::unique_ptr<std::atomic<detail::EventSlot*>[]> chunks_;
+    std::atomic<uint32_t> pool_size_{0};
+    std::atomic<uint64_t> free_head_{0};  // ABA tag << 32 | (index + 1)
+    std::atomic<size_t> active_{0};
+    
+    std::mutex mutex_;  // Pool growth and the poller
+    std::condition_variable wake_;
+    std::atomic<size_t> watched_{0};  // Slots the poller has yet to complete
+    std::atomic<bool> idle_{false};
+    bool stopping_;
+    std::thread poller_;
+};
+
+} // namespace ocl
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ocl {
+
+// ============================================================================
+// Executor - runs continuations (e.g. after an OpenCL event completes)
+// ============================================================================
+
+class Executor {
+public:
+    virtual ~Executor() = default;
+    
+    // Schedule a task; must not block. Tasks should not throw.
+    virtual void execute(std::function<void()> task) = 0;
+};
+
+// Runs tasks immediately on the calling thread. For event continuations
+// that is the OpenCL callback thread, so tasks must be short and must not
+// call blocking OpenCL functions (clFinish, clWaitForEvents, ...).
+class InlineExecutor : public Executor {
+public:
+    void execute(std::function<void()> task) override { task(); }
+};
+
+// Fixed set of worker threads sharing a FIFO task queue
+// Usage: ThreadPoolExecutor pool(4); pool.execute([] { ... });
+class ThreadPoolExecutor : public Executor {
+public:
+    explicit ThreadPoolExecutor(size_t threads = 0);  // 0 = hardware threads
+    ~ThreadPoolExecutor() override;                   // Runs queued tasks, then joins
+    
+    // Disable copying
+    ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+    ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+    
+    void execute(std::function<void()> task) override;
+    
+    size_t getThreadCount() const { return workers_.size(); }
+    
+private:
+    void run();
+    
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopping_;
+    std::vector<std::thread> workers_;
+};
+
+// Process-wide thread pool used when no executor is given
+Executor& defaultExecutor();
+
+} // namespace ocl
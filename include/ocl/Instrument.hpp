@@ -0,0 +1,185 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+// Records kept per thread before the oldest are overwritten (power of two)
+#ifndef OCL_INSTRUMENT_RING_SIZE
+#define OCL_INSTRUMENT_RING_SIZE 8192
+#endif
+
+namespace ocl {
+
+// ============================================================================
+// Instrumentation scopes - compile-time toggled, TSC-timed
+// ============================================================================
+
+// Usage:
+//   void step() {
+//       OCL_PROFILE_SCOPE("step");        // Name must be a string literal
+//       ...
+//   }
+//   ocl::Instrument::printResults();
+//
+// With OCL_ENABLE_INSTRUMENTATION off (CMake option, the default) the
+// macros expand to nothing. When on, a scope costs two timestamp-counter
+// reads and one write into a per-thread ring buffer; names are static, so
+// nothing is allocated or hashed. Records are aggregated only when results
+// are requested.
+
+// One per OCL_PROFILE_SCOPE site (static storage)
+struct ScopeSite {
+    const char* name;
+    const char* file;
+    int line;
+};
+
+// Inclusive time of one site, over all threads
+struct ScopeStats {
+    std::string name;
+    std::string file;
+    int line = 0;
+    size_t count = 0;
+    double total_ms = 0.0;
+    double min_ms = 0.0;
+    double max_ms = 0.0;
+    
+    double getAverageMs() const { return count > 0 ? total_ms / count : 0.0; }
+};
+
+namespace detail {
+    // Timestamp counter (steady_clock nanoseconds where there is none)
+    inline uint64_t readTicks() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+    
+    // Fields are relaxed atomics so the collector can read while the
+    // owning thread writes; torn records are detected through `head`
+    struct ScopeRecord {
+        std::atomic<const ScopeSite*> site;
+        std::atomic<uint64_t> start;
+        std::atomic<uint64_t> end;
+    };
+    
+    struct ThreadRing {
+        static const size_t kSize = OCL_INSTRUMENT_RING_SIZE;
+        static_assert((kSize & (kSize - 1)) == 0, "OCL_INSTRUMENT_RING_SIZE must be a power of two");
+        
+        ScopeRecord records[kSize];
+        std::atomic<uint64_t> head{0};  // Records ever written by the owner
+        uint64_t consumed = 0;          // Collector only
+    };
+    
+    // A ring for the calling thread: reused from an exited thread if one
+    // is free, so memory is bounded by the peak thread count. Unread
+    // records stay in a ring after its thread exits. `slot` is cleared when
+    // the thread exits and the ring is handed back.
+    ThreadRing* registerThreadRing(ThreadRing** slot);
+    
+    inline ThreadRing& threadRing() {
+        static thread_local ThreadRing* ring = nullptr;
+        if (!ring) {
+            ring = registerThreadRing(&ring);
+        }
+        return *ring;
+    }
+}
+
+// RAII scope behind OCL_PROFILE_SCOPE
+class ProfileScope {
+public:
+    explicit ProfileScope(const ScopeSite& site) : site_(&site), start_(detail::readTicks()) {}
+    
+    ~ProfileScope() {
+        const uint64_t end = detail::readTicks();
+        detail::ThreadRing& ring = detail::threadRing();
+        const uint64_t head = ring.head.load(std::memory_order_relaxed);
+        detail::ScopeRecord& record = ring.records[head & (detail::ThreadRing::kSize - 1)];
+        record.site.store(site_, std::memory_order_relaxed);
+        record.start.store(start_, std::memory_order_relaxed);
+        record.end.store(end, std::memory_order_relaxed);
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+    
+    // Disable copying
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+    
+private:
+    const ScopeSite* site_;
+    uint64_t start_;
+};
+
+// Aggregated results of all threads' scopes
+class Instrument {
+public:
+    // Whether OCL_PROFILE_SCOPE records anything in this build
+    static constexpr bool isEnabled() {
+#if defined(OCL_ENABLE_INSTRUMENTATION) && OCL_ENABLE_INSTRUMENTATION
+        return true;
+#else
+        return false;
+#endif
+    }
+    
+    // Per-site totals, slowest first (folds in all records written so far)
+    static std::vector<ScopeStats> getStats();
+    
+    // Records overwritten before they could be aggregated
+    static uint64_t getDroppedRecords();
+    
+    // Timestamp counter rate, calibrated against steady_clock
+    static double getTicksPerSecond();
+    
+    static void printResults();
+    static void reset();
+};
+
+} // namespace ocl
+
+// ============================================================================
+// Macros
+// ============================================================================
+
+#define OCL_INSTRUMENT_CONCAT_IMPL(a, b) a##b
+#define OCL_INSTRUMENT_CONCAT(a, b) OCL_INSTRUMENT_CONCAT_IMPL(a, b)
+
+#if defined(OCL_ENABLE_INSTRUMENTATION) && OCL_ENABLE_INSTRUMENTATION
+
+#define OCL_PROFILE_SCOPE_NAMED(name)                                                          \
+    static const ::ocl::ScopeSite OCL_INSTRUMENT_CONCAT(ocl_scope_site_, __LINE__) = {        \
+        name, __FILE__, __LINE__};                                                             \
+    ::ocl::ProfileScope OCL_INSTRUMENT_CONCAT(ocl_scope_, __LINE__)(                           \
+        OCL_INSTRUMENT_CONCAT(ocl_scope_site_, __LINE__))
+
+// `"" name` only compiles for string literals
+#define OCL_PROFILE_SCOPE(name) OCL_PROFILE_SCOPE_NAMED("" name)
+#define OCL_PROFILE_FUNCTION() OCL_PROFILE_SCOPE_NAMED(__func__)
+
+#else
+
+#define OCL_PROFILE_SCOPE(name) static_cast<void>(0)
+#define OCL_PROFILE_FUNCTION() static_cast<void>(0)
+
+#endif
@@ -10,8 +10,36 @@ namespace ocl {
 class Program;
 class CommandQueue;
 class Device;
+class Counter;
+namespace detail { struct KernelTiming; }
 template<typename T> class Buffer;
 
+namespace detail {
+    // CL_KERNEL_FUNCTION_NAME of a kernel (throws ocl::Error)
+    std::string kernelName(cl_kernel kernel);
+}
+
+// ============================================================================
+// KernelInfo - resource usage of a compiled kernel on one device
+// ============================================================================
+
+struct KernelInfo {
+    std::string name;
+    size_t work_group_size = 0;                     // Largest local size (lowered by register pressure)
+    size_t preferred_multiple = 1;                  // SIMD / warp / wavefront width
+    size_t compile_work_group_size[3] = {0, 0, 0};  // reqd_work_group_size, all zero if unset
+    cl_ulong local_mem_size = 0;                    // Static __local bytes per work-group
+    cl_ulong private_mem_size = 0;                  // Private bytes per work-item
+    cl_ulong spill_mem_size = 0;                    // Register spill bytes per work-item
+    bool has_spill_info = false;                    // Only some drivers report spills (Intel)
+    
+    bool hasCompileWorkGroupSize() const { return compile_work_group_size[0] != 0; }
+    bool spills() const { return spill_mem_size > 0; }
+    
+    // One-line summary, e.g. "reduce_sum: wg<=256 (x32), local 1024 B, private 0 B, spill 0 B"
+    std::string toString() const;
+};
+
 // ============================================================================
 // Kernel - manages OpenCL kernel with RAII
 // ============================================================================
@@ -20,6 +48,7 @@ class Kernel {
 public:
     Kernel();
     Kernel(const Program& program, const std::string& name);
+    explicit Kernel(cl_kernel kernel);  // Takes ownership
     
     ~Kernel();
     
@@ -35,7 +64,9 @@ public:
     template<typename T>
     void setArg(cl_uint index, const T& value) {
         cl_int err = clSetKernelArg(kernel_, index, sizeof(T), &value);
-        checkError(err, "setting kernel arg " + std::to_string(index));
+        if (err != CL_SUCCESS) {
+            throw Error(err, "setting kernel arg " + std::to_string(index));
+        }
     }
     
     // Set argument for cl_mem (buffers pass their cl_mem handle)
@@ -69,12 +100,24 @@ public:
     size_t getWorkGroupSize(const Device& device) const;
     size_t getPreferredWorkGroupSizeMultiple(const Device& device) const;
     cl_ulong getLocalMemSize(const Device& device) const;
+    cl_ulong getPrivateMemSize(const Device& device) const;
+    
+    // All of the above plus the required work-group size and spill size
+    KernelInfo getInfo(const Device& device) const;
+    
+    std::string getName() const;
     
     // Get underlying kernel
     cl_kernel get() const { return kernel_; }
     
 private:
     cl_kernel kernel_;
+    Counter* launches_;              // ocl_kernel_launches_total series, looked up on first launch
+    detail::KernelTiming* timing_;   // Looked up on the first launch with kernel timing on
+    
+    // Weight of the next launch if it is sampled for timing (it then needs an event)
+    uint32_t sampleLaunch();
+    void countLaunch(cl_event event, uint32_t weight);
     
     // Helper for variadic setArgs - base case
     void setArgsImpl(cl_uint) {}
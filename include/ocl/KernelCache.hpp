@@ -0,0 +1,86 @@
+#pragma once
+
+#include <ocl/Errors.hpp>
+#include <ocl/Context.hpp>
+#include <ocl/KernelPool.hpp>
+#include <ocl/Program.hpp>
+#include <ocl/SourceLoader.hpp>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ocl {
+
+// Forward declaration
+class Device;
+
+// ============================================================================
+// KernelCache - built programs and kernels shared across a context
+// ============================================================================
+
+// Identifies one kernel: source id, kernel name and build options
+struct KernelKey {
+    std::string source;
+    std::string name;
+    std::string options;
+};
+
+// A source id is, in lookup order: a source added with addSource(), an
+// embedded file (built with Program::buildEmbedded), or a file path.
+// Includes are resolved by getSourceLoader() (configure it before use).
+// Each (device, source, options) is built once; concurrent requests for a
+// key being built wait for that build instead of starting their own.
+// Usage:
+//   auto& cache = KernelCache::forContext(ctx);
+//   cache.warmup(device, {{"vector_add.cl", "vector_add"}});   // At startup
+//   KernelPool::Lease kernel = cache.get(device, "vector_add.cl", "vector_add").acquire();
+class KernelCache {
+public:
+    explicit KernelCache(const Context& context);
+    
+    // Disable copying and moving (returned references point into the cache)
+    KernelCache(const KernelCache&) = delete;
+    KernelCache& operator=(const KernelCache&) = delete;
+    
+    // Process-wide cache of a context, created on first use. It keeps the
+    // context alive until release() (thread-safe)
+    static KernelCache& forContext(const Context& context);
+    static void release(const Context& context);
+    
+    // Register in-memory source under an id (programs already built from it are kept)
+    void addSource(const std::string& id, const std::string& source);
+    
+    // Built program, valid for the cache's lifetime. Build errors are
+    // rethrown to every waiter; the next call retries.
+    const Program& getProgram(const Device& device, const std::string& source, const std::string& options = "");
+    
+    // Kernel instances of a built program (leases are safe across threads)
+    KernelPool& get(const Device& device, const std::string& source, const std::string& name,
+                    const std::string& options = "");
+    
+    // Build every kernel before the first request, on up to `threads`
+    // threads (0 = hardware threads); rethrows the first failure
+    void warmup(const Device& device, const std::vector<KernelKey>& kernels, size_t threads = 0);
+    
+    size_t getProgramCount() const;
+    
+    SourceLoader& getSourceLoader() { return loader_; }
+    
+    const Context& getContext() const { return context_; }
+    
+private:
+    KernelSource loadSource(const std::string& id) const;
+    
+    Context context_;  // Own reference to the context
+    SourceLoader loader_;
+    
+    mutable std::mutex mutex_;
+    std::map<std::string, std::string> sources_;
+    std::map<std::string, std::shared_future<std::shared_ptr<Program>>> programs_;  // By device/source/options
+    std::map<std::string, std::unique_ptr<KernelPool>> kernels_;                     // By program key + name
+};
+
+} // namespace ocl
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <ocl/Errors.hpp>
+#include <ocl/Types.hpp>
+#include <ocl/Buffer.hpp>
+#include <ocl/CommandQueue.hpp>
+#include <ocl/Event.hpp>
+#include <ocl/Instrument.hpp>
+#include <ocl/Kernel.hpp>
+#include <ocl/Metrics.hpp>
+#include <ocl/NDRange.hpp>
+#include <ocl/Profiler.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ocl {
+
+// Forward declaration
+class Program;
+
+// ============================================================================
+// Local - __local memory argument of `count` elements of T
+// ============================================================================
+
+template<typename T>
+struct Local {
+    explicit Local(size_t n) : count(n) {}
+    size_t count;
+};
+
+// __local T* in the kernel signature
+template<typename T> struct TypeName<Local<T>> {
+    static std::string name() { return TypeName<T>::name() + "*"; }
+};
+
+// ============================================================================
+// KernelArg - how each host argument type is bound to a kernel
+// ============================================================================
+
+// Scalars are passed by value
+template<typename T>
+struct KernelArg {
+    static cl_kernel_arg_address_qualifier address() { return CL_KERNEL_ARG_ADDRESS_PRIVATE; }
+    static cl_int set(cl_kernel kernel, cl_uint index, const T& value) {
+        return clSetKernelArg(kernel, index, sizeof(T), &value);
+    }
+    static double bytes(const T&) { return 0.0; }
+};
+
+// Buffers are passed as their cl_mem handle
+template<typename T>
+struct KernelArg<Buffer<T>> {
+    static cl_kernel_arg_address_qualifier address() { return CL_KERNEL_ARG_ADDRESS_GLOBAL; }
+    static cl_int set(cl_kernel kernel, cl_uint index, const Buffer<T>& buffer) {
+        cl_mem mem = buffer.get();
+        return clSetKernelArg(kernel, index, sizeof(cl_mem), &mem);
+    }
+    static double bytes(const Buffer<T>& buffer) { return static_cast<double>(buffer.sizeBytes()); }
+};
+
+// Local memory is sized, with no data
+template<typename T>
+struct KernelArg<Local<T>> {
+    static cl_kernel_arg_address_qualifier address() { return CL_KERNEL_ARG_ADDRESS_LOCAL; }
+    static cl_int set(cl_kernel kernel, cl_uint index, const Local<T>& local) {
+        return clSetKernelArg(kernel, index, local.count * sizeof(T), nullptr);
+    }
+    static double bytes(const Local<T>&) { return 0.0; }
+};
+
+// Expected OpenCL type and address space of one kernel argument
+struct KernelArgSpec {
+    std::string type;   // e.g. "float*", "int"
+    cl_kernel_arg_address_qualifier address;
+};
+
+// Check a kernel's arguments against a signature (throws std::invalid_argument).
+// The argument count is always checked; types and address spaces need the
+// program to be built with -cl-kernel-arg-info and are skipped otherwise.
+void validateKernelArgs(cl_kernel kernel, const std::vector<KernelArgSpec>& expected);
+
+// Which arguments are const-qualified (read-only) pointers; empty if the
+// program was built without -cl-kernel-arg-info
+std::vector<bool> getConstArgs(cl_kernel kernel);
+
+// ============================================================================
+// KernelFunctor - kernel with a typed, validated signature
+// ============================================================================
+
+template<typename... Args>
+class KernelFunctor {
+public:
+    // Usage: KernelFunctor<Buffer<float>, Buffer<float>, Buffer<float>, int> add(prog, "vector_add");
+    KernelFunctor(const Program& program, const std::string& name)
+        : kernel_(program, name), name_(name), launches_(&detail::kernelLaunchCounter(name)), timing_(nullptr) {
+        validateKernelArgs(kernel_.get(), {KernelArgSpec{typeName<Args>(), KernelArg<Args>::address()}...});
+        const_args_ = getConstArgs(kernel_.get());
+    }
+    
+    // Work per launch as a function of the launch arguments, reported by
+    // the Profiler as GB/s and GFLOP/s. Without a model, bytes are derived
+    // from the buffer sizes: const pointers are read, others written (needs
+    // -cl-kernel-arg-info; FLOPs are then unknown).
+    // Usage: add.setCostModel([](const Range&, const Buffer<float>&, const Buffer<float>&,
+    //                            const Buffer<float>&, int n) {
+    //     KernelCost cost;
+    //     cost.bytes_read = 2.0 * n * sizeof(float);
+    //     cost.bytes_written = n * sizeof(float);
+    //     cost.flops = n;
+    //     return cost;
+    // });
+    using CostModel = std::function<KernelCost(const Range&, const Args&...)>;
+    void setCostModel(CostModel model) { cost_model_ = std::move(model); }
+    
+    KernelCost getCost(const Range& range, const Args&... args) const {
+        return cost_model_ ? cost_model_(range, args...) : derivedCost(args...);
+    }
+    
+    // Bind all arguments and enqueue (not thread-safe: arguments are kernel state)
+    // Usage: ocl::Event e = add(queue, Range::of1D(global, 256), a, b, c, n);
+    Event operator()(const CommandQueue& queue, const Range& range, const Args&... args) {
+        OCL_PROFILE_SCOPE("KernelFunctor::operator()");
+        
+        // Errors are accumulated rather than checked per argument; the
+        // braced list guarantees left-to-right evaluation
+        cl_int err = CL_SUCCESS;
+        cl_uint index = 0;
+        using expand = int[];
+        (void)expand{0, (err |= KernelArg<Args>::set(kernel_.get(), index++, args), 0)...};
+        (void)index;
+        if (err != CL_SUCCESS) {
+            bindChecked(args...);
+        }
+        
+        cl_event event;
+        err = clEnqueueNDRangeKernel(queue.get(), kernel_.get(), range.dims, nullptr,
+                                     range.global, range.localSizes(), 0, nullptr, &event);
+        checkError(err, "executing kernel");
+        
+        Event launched(event);
+        launches_->inc();
+        if (Metrics::instance().isKernelTiming()) {
+            if (!timing_) {
+                timing_ = &detail::kernelTiming(name_);
+            }
+            if (const uint32_t weight = timing_->sampler.next()) {
+                detail::observeKernelDuration(launched.get(), timing_->durations, weight);
+            }
+        }
+        Profiler& profiler = Profiler::instance();
+        if (profiler.isKernelProfiling()) {
+            profiler.recordKernel(name_, launched, getCost(range, args...));
+        }
+        return launched;
+    }
+    
+    // Underlying kernel (for introspection, e.g. NDRange::getOptimal1D)
+    Kernel& getKernel() { return kernel_; }
+    const Kernel& getKernel() const { return kernel_; }
+    
+private:
+    Kernel kernel_;
+    std::string name_;
+    std::vector<bool> const_args_;
+    CostModel cost_model_;
+    Counter* launches_;
+    detail::KernelTiming* timing_;  // Created on the first timed launch
+    
+    KernelCost derivedCost(const Args&... args) const {
+        KernelCost cost;
+        if (const_args_.size() != sizeof...(Args)) {
+            return cost;
+        }
+        cl_uint index = 0;
+        using expand = int[];
+        (void)expand{0, ((const_args_[index] ? cost.bytes_read : cost.bytes_written) += KernelArg<Args>::bytes(args),
+                         ++index, 0)...};
+        (void)index;
+        return cost;
+    }
+    
+    // Slow path after a failed bind: rebind one by one to report which argument failed
+    void bindChecked(const Args&... args) {
+        cl_uint index = 0;
+        using expand = int[];
+        (void)expand{0, (checkError(KernelArg<Args>::set(kernel_.get(), index, args),
+                                    "setting kernel arg " + std::to_string(index)), ++index, 0)...};
+        throw Error(CL_INVALID_KERNEL_ARGS, "setting kernel args");
+    }
+};
+
+} // namespace ocl
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <ocl/Errors.hpp>
+#include <ocl/Kernel.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ocl {
+
+// Forward declaration
+class Program;
+
+// ============================================================================
+// KernelPool - per-thread kernel instances for concurrent argument binding
+// ============================================================================
+
+// cl_kernel argument state is shared, so threads must not bind arguments on
+// the same kernel at once. The pool lends out separate instances: clones of
+// a prototype (clCloneKernel, OpenCL 2.1+) or fresh kernels from the program.
+// Usage:
+//   KernelPool pool(prog, "vector_add");
+//   {
+//       KernelPool::Lease kernel = pool.acquire();
+//       kernel->setArgs(a, b, c, n);
+//       kernel->execute(queue, global, local);
+//   }   // Returned to the pool
+class KernelPool {
+public:
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease();
+        
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        
+        Kernel& operator*() const { return *kernel_; }
+        Kernel* operator->() const { return kernel_; }
+        Kernel& get() const { return *kernel_; }
+        
+    private:
+        friend class KernelPool;
+        Lease(KernelPool* pool, Kernel* kernel, size_t slot, std::unique_ptr<Kernel> overflow);
+        void release();
+        
+        KernelPool* pool_;
+        Kernel* kernel_;
+        size_t slot_;                        // Slot index (max size_t for overflow)
+        std::unique_ptr<Kernel> overflow_;
+    };
+    
+    // capacity = lock-free slots (0 = number of hardware threads). Instances
+    // are created on first use; demand beyond capacity goes through a
+    // mutex-guarded overflow list.
+    KernelPool(const Program& program, const std::string& name, size_t capacity = 0);
+    ~KernelPool();
+    
+    // Disable copying and moving (leases point into the pool)
+    KernelPool(const KernelPool&) = delete;
+    KernelPool& operator=(const KernelPool&) = delete;
+    
+    // Borrow a kernel instance (returned when the lease is destroyed)
+    Lease acquire();
+    
+    size_t getCapacity() const { return capacity_; }
+    size_t getInstanceCount() const { return instances_.load(std::memory_order_relaxed); }
+    bool usesClone() const { return use_clone_; }
+    
+private:
+    enum SlotState { Empty, Free, InUse };
+    
+    struct Slot {
+        std::atomic<int> state{Empty};
+        Kernel kernel;
+    };
+    
+    Kernel createInstance();
+    void release(size_t slot, std::unique_ptr<Kernel> overflow);
+    
+    cl_program program_;
+    std::string name_;
+    Kernel prototype_;
+    bool use_clone_;
+    size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> instances_;
+    
+    std::mutex overflow_mutex_;
+    std::vector<std::unique_ptr<Kernel>> overflow_;
+};
+
+} // namespace ocl
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <ocl/Errors.hpp>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ocl {
+
+// ============================================================================
+// Metric types - updated lock-free, read by Metrics::render()
+// ============================================================================
+
+// Monotonically increasing count (exported as <name>_total)
+class Counter {
+public:
+    void inc(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+    
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+// Value that can go up and down
+class Gauge {
+public:
+    void add(int64_t delta) { value_.fetch_add(delta, std::memory_order_relaxed); }
+    void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+    
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+// Distribution over fixed bucket upper bounds (plus +Inf)
+class Histogram {
+public:
+    explicit Histogram(std::vector<double> bounds);
+    
+    // `weight` > 1 records a sample that stands for that many observations
+    void observe(double value, uint64_t weight = 1);
+    
+    const std::vector<double>& getBounds() const { return bounds_; }
+    uint64_t getBucketCount(size_t index) const { return buckets_[index].load(std::memory_order_relaxed); }  // Not cumulative
+    uint64_t getCount() const { return count_.load(std::memory_order_relaxed); }
+    double getSum() const { return sum_.load(std::memory_order_relaxed); }
+    
+private:
+    std::vector<double> bounds_;
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets_;  // bounds_.size() + 1
+    std::atomic<uint64_t> count_{0};
+    std::atomic<double> sum_{0.0};
+};
+
+// ============================================================================
+// KernelSampler - chooses which launches of a kernel get device-timed
+// ============================================================================
+
+struct KernelSampling {
+    uint32_t period = 1;          // Time 1 in `period` launches per kernel (initial value if adaptive)
+    double target_rate = 0.0;     // > 0: adapt the period to about this many samples/s per kernel
+    uint32_t max_period = 65536;  // Upper bound for the adaptive period
+};
+
+// Every period-th launch is sampled and weighted by the period, so
+// histogram counts and sums estimate all launches. The adaptive period is
+// re-evaluated on sampled launches, once per second of traffic.
+class KernelSampler {
+public:
+    explicit KernelSampler(const KernelSampling& config) { configure(config); }
+    
+    void configure(const KernelSampling& config);
+    
+    // Launches this one stands for if it should be timed, 0 otherwise
+    uint32_t next() {
+        if (countdown_.fetch_sub(1, std::memory_order_relaxed) != 1) {
+            return 0;
+        }
+        const uint32_t weight = period_.load(std::memory_order_relaxed);
+        if (target_rate_.load(std::memory_order_relaxed) > 0.0) {
+            adapt(weight);
+        }
+        countdown_.store(period_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return weight;
+    }
+    
+    uint32_t getPeriod() const { return period_.load(std::memory_order_relaxed); }
+    
+private:
+    void adapt(uint32_t weight);
+    
+    std::atomic<int64_t> countdown_{1};
+    std::atomic<uint32_t> period_{1};
+    std::atomic<uint32_t> max_period_{1};
+    std::atomic<double> target_rate_{0.0};
+    
+    // Rate window, owned by whoever holds adapting_
+    std::atomic_flag adapting_ = ATOMIC_FLAG_INIT;
+    uint64_t window_launches_ = 0;
+    int64_t window_start_ns_ = 0;
+};
+
+// ============================================================================
+// Metrics - registry of library telemetry, exported as OpenMetrics text
+// ============================================================================
+
+// Built-in metrics (always on unless noted):
+//   ocl_kernel_launches_total{kernel}          Kernel and KernelFunctor launches
+//   ocl_kernel_duration_seconds{kernel}        Kernel device time (setKernelTiming/Sampling)
+//   ocl_transfer_bytes_total{direction}        host_to_device, device_to_host, device_to_device
+//   ocl_device_memory_bytes                    Live Buffer allocations
+//   ocl_kernel_pool_acquires_total{result}     KernelPool hit / miss
+//   ocl_program_cache_lookups_total{result}    Program::specialize hit / miss
+//   ocl_program_build_seconds                  Program build time
+//
+// Usage:
+//   auto& requests = Metrics::instance().counter("app_requests", "Requests served");
+//   requests.inc();
+//   std::string text = Metrics::instance().render();  // Serve from your own endpoint
+class Metrics {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+    
+    static Metrics& instance();
+    
+    // Get or create a series. The returned reference stays valid for the
+    // program's lifetime: look it up once, then update it lock-free.
+    // Throws std::invalid_argument if `name` is registered with another type.
+    Counter& counter(const std::string& name, const std::string& help, const Labels& labels = {});
+    Gauge& gauge(const std::string& name, const std::string& help, const Labels& labels = {});
+    Histogram& histogram(const std::string& name, const std::string& help, const Labels& labels = {},
+                         const std::vector<double>& bounds = defaultBuckets());
+    
+    // All metrics in OpenMetrics text format (ends with "# EOF")
+    std::string render() const;
+    
+    // Record device time of sampled kernel launches through event
+    // callbacks (needs CL_QUEUE_PROFILING_ENABLE). Every launch is sampled
+    // unless setKernelSampling says otherwise.
+    void setKernelTiming(bool enabled) { kernel_timing_.store(enabled, std::memory_order_relaxed); }
+    bool isKernelTiming() const { return kernel_timing_.load(std::memory_order_relaxed); }
+    
+    // Sample 1 in N launches (fixed or adaptive) and enable kernel timing;
+    // the overload configures one kernel, overriding the default
+    // Usage: Metrics::instance().setKernelSampling({64});        // Fixed 1 in 64
+    //        KernelSampling adaptive; adaptive.target_rate = 10;  // ~10 samples/s per kernel
+    void setKernelSampling(const KernelSampling& sampling);
+    void setKernelSampling(const std::string& kernel, const KernelSampling& sampling);
+    
+    // Seconds, 10 us to 10 s
+    static std::vector<double> defaultBuckets();
+    
+private:
+    Metrics() = default;
+    
+    enum class Type { Counter, Gauge, Histogram };
+    
+    struct Series {
+        Labels labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+    
+    struct Family {
+        Type type;
+        std::string help;
+        std::map<std::string, Series> series;  // By rendered label set
+    };
+    
+    Series& getSeries(const std::string& name, const std::string& help, Type type, const Labels& labels);
+    
+    mutable std::mutex mutex_;  // Registration and render only
+    std::map<std::string, Family> families_;
+    std::atomic<bool> kernel_timing_{false};
+};
+
+// ============================================================================
+// MetricsServer - minimal HTTP endpoint serving Metrics::render()
+// ============================================================================
+
+// Answers GET /metrics on a background thread (POSIX only; throws
+// std::runtime_error elsewhere). Port 0 picks a free port.
+// Usage: MetricsServer server(9464);  // curl localhost:9464/metrics
+class MetricsServer {
+public:
+    explicit MetricsServer(uint16_t port, const std::string& address = "127.0.0.1");
+    ~MetricsServer();
+    
+    // Disable copying
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+    
+    uint16_t getPort() const { return port_; }
+    
+private:
+    void run();
+    
+    int socket_;
+    uint16_t port_;
+    std::atomic<bool> stopping_;
+    std::thread thread_;
+};
+
+// ============================================================================
+// Library hooks (used by Kernel, KernelFunctor, KernelPool and Program)
+// ============================================================================
+
+namespace detail {
+    // Duration histogram and sampler of one kernel
+    struct KernelTiming {
+        KernelTiming(Histogram& histogram, const KernelSampling& sampling) : durations(histogram), sampler(sampling) {}
+        
+        Histogram& durations;
+        KernelSampler sampler;
+    };
+    
+    Counter& kernelLaunchCounter(const std::string& name);
+    KernelTiming& kernelTiming(const std::string& name);
+    void observeKernelDuration(cl_event event, Histogram& histogram, uint64_t weight);
+    void recordPoolAcquire(bool hit);
+    void recordProgramCache(bool hit);
+    void recordProgramBuild(double seconds);
+}
+
+} // namespace ocl
@@ -10,6 +10,56 @@ namespace ocl {
 // Forward declaration
 class Device;
 class Kernel;
+struct KernelInfo;
+
+// ============================================================================
+// Range - global/local sizes for a kernel launch (1 to 3 dimensions)
+// ============================================================================
+
+struct Range {
+    cl_uint dims;
+    size_t global[3];
+    size_t local[3];   // All zero = let the implementation choose
+    
+    // Usage: Range::of1D(N, 256), Range::of2D(width, height, 16, 16)
+    static Range of1D(size_t x, size_t local_x = 0) {
+        return {1, {x, 1, 1}, {local_x, 1, 1}};
+    }
+    
+    static Range of2D(size_t x, size_t y, size_t local_x = 0, size_t local_y = 0) {
+        return {2, {x, y, 1}, {local_x, local_y, 1}};
+    }
+    
+    static Range of3D(size_t x, size_t y, size_t z, size_t local_x = 0, size_t local_y = 0, size_t local_z = 0) {
+        return {3, {x, y, z}, {local_x, local_y, local_z}};
+    }
+    
+    // Local sizes for clEnqueueNDRangeKernel (nullptr unless all are set)
+    const size_t* localSizes() const {
+        for (cl_uint i = 0; i < dims; ++i) {
+            if (local[i] == 0) return nullptr;
+        }
+        return local;
+    }
+};
+
+// ============================================================================
+// Occupancy - estimated residency of one work-group size on a compute unit
+// ============================================================================
+
+// A model, not a measurement: OpenCL exposes neither register counts nor
+// per-CU thread limits, so they are inferred. A compute unit is assumed to
+// hold twice the device's largest work-group, at most 16 work-groups, and
+// CL_DEVICE_LOCAL_MEM_SIZE bytes of local memory; a kernel whose
+// CL_KERNEL_WORK_GROUP_SIZE is below the device maximum is register-limited
+// and taken to fit only that many work-items. Work-groups occupy whole
+// SIMD/warp slots (the preferred multiple).
+struct Occupancy {
+    size_t work_groups_per_cu = 0;    // 0 = the configuration cannot launch
+    size_t resident_work_items = 0;   // Per compute unit
+    double occupancy = 0.0;           // resident / maximum resident work-items (0..1)
+    const char* limiter = "";         // "work-group size", "work-groups", "work-items", "registers", "local memory"
+};
 
 // ============================================================================
 // NDRange - Utilities for work group size calculations
@@ -17,16 +67,37 @@ class Kernel;
 
 class NDRange {
 public:
-    // Calculate optimal 1D work group size
-    static size_t getOptimal1D(const Kernel& kernel, const Device& device, size_t global_size);
+    // The getOptimal* functions return the kernel's reqd_work_group_size when
+    // it has one; otherwise the candidate size with the highest estimated
+    // occupancy (2D and 3D candidates must divide the global sizes).
+    // local_mem_per_item is dynamic local memory (setLocalArg) per
+    // work-item, if it scales with the work-group size.
+    
+    // Calculate optimal 1D work group size. The result need not divide
+    // global_size (pad with getPaddedGlobalSize); among equally resident
+    // sizes one that divides it wins, then the larger one
+    // Usage: size_t local = NDRange::getOptimal1D(kernel, device, N);
+    //        kernel.execute(queue, NDRange::getPaddedGlobalSize(N, local), local);  // Kernel checks id < N
+    static size_t getOptimal1D(const Kernel& kernel, const Device& device, size_t global_size,
+                               size_t local_mem_per_item = 0);
     
     // Calculate optimal 2D work group sizes
     static std::array<size_t, 2> getOptimal2D(const Kernel& kernel, const Device& device, 
-                                               size_t global_x, size_t global_y);
+                                               size_t global_x, size_t global_y,
+                                               size_t local_mem_per_item = 0);
     
     // Calculate optimal 3D work group sizes
     static std::array<size_t, 3> getOptimal3D(const Kernel& kernel, const Device& device,
-                                               size_t global_x, size_t global_y, size_t global_z);
+                                               size_t global_x, size_t global_y, size_t global_z,
+                                               size_t local_mem_per_item = 0);
+    
+    // Estimate resident work-groups per compute unit for a work-group of
+    // local_size work-items using local_mem_bytes of dynamic local memory
+    // (on top of the kernel's static __local usage)
+    static Occupancy estimateOccupancy(const Kernel& kernel, const Device& device,
+                                       size_t local_size, size_t local_mem_bytes = 0);
+    static Occupancy estimateOccupancy(const KernelInfo& info, const Device& device,
+                                       size_t local_size, size_t local_mem_bytes = 0);
     
     // Round up to nearest multiple (for padding global size)
     static size_t roundUp(size_t value, size_t multiple) {
@@ -1,12 +1,42 @@
 #pragma once
 
 #include <ocl/Errors.hpp>
+#include <ocl/Event.hpp>
+#include <atomic>
 #include <string>
 #include <chrono>
+#include <map>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace ocl {
 
+// ============================================================================
+// KernelCost - hardware-independent work done by one kernel launch
+// ============================================================================
+
+struct KernelCost {
+    double bytes_read = 0.0;
+    double bytes_written = 0.0;
+    double flops = 0.0;
+    
+    double getBytes() const { return bytes_read + bytes_written; }
+};
+
+// Launches of one kernel, aggregated by the profiler
+struct KernelStats {
+    std::string name;
+    size_t launches = 0;
+    size_t timed_launches = 0;   // Launches with event profiling info
+    double total_ms = 0.0;       // Device time of the timed launches
+    KernelCost cost;             // Summed over the timed launches
+    
+    double getGBPerSecond() const { return total_ms > 0 ? cost.getBytes() / (total_ms * 1e6) : 0.0; }
+    double getGFLOPPerSecond() const { return total_ms > 0 ? cost.flops / (total_ms * 1e6) : 0.0; }
+    double getIntensity() const { return cost.getBytes() > 0 ? cost.flops / cost.getBytes() : 0.0; }  // FLOP/byte
+};
+
 // ============================================================================
 // Profiler - Performance profiling utilities
 // ============================================================================
@@ -16,7 +46,8 @@ public:
     using TimePoint = std::chrono::high_resolution_clock::time_point;
     using Duration = std::chrono::duration<double, std::milli>;
     
-    // Start timing an operation
+    // Start timing an operation (map lookup per call; use OCL_PROFILE_SCOPE
+    // from Instrument.hpp inside hot loops)
     void start(const std::string& name);
     
     // Stop timing an operation
@@ -28,9 +59,27 @@ public:
     // Print all profiling results
     void printResults() const;
     
-    // Reset all timers
+    // Reset all timers and kernel statistics
     void reset();
     
+    // Kernel accounting: while enabled, every KernelFunctor launch is
+    // recorded with its cost. Durations come from event profiling, so
+    // queues need CL_QUEUE_PROFILING_ENABLE.
+    void setKernelProfiling(bool enabled) { kernel_profiling_.store(enabled, std::memory_order_relaxed); }
+    bool isKernelProfiling() const { return kernel_profiling_.load(std::memory_order_relaxed); }
+    
+    // Record a launch made outside KernelFunctor (thread-safe)
+    void recordKernel(const std::string& name, const Event& event, const KernelCost& cost);
+    
+    // Per-kernel totals; waits for all recorded launches to complete
+    std::vector<KernelStats> getKernelStats();
+    
+    // Print achieved GB/s, GFLOP/s and intensity per kernel. With device
+    // peaks set (e.g. measured by the roofline example) each kernel is also
+    // shown as a fraction of its roof and classified memory/compute bound.
+    void printKernelResults();
+    void setDevicePeaks(double gb_per_s, double gflop_per_s);
+    
     // Get singleton instance
     static Profiler& instance();
     
@@ -44,6 +93,22 @@ private:
     };
     
     std::unordered_map<std::string, TimingData> timings_;
+    
+    struct PendingLaunch {
+        std::string name;
+        Event event;
+        KernelCost cost;
+    };
+    
+    // Fold launches into kernel_stats_; only completed ones unless `wait`
+    void collectLaunches(bool wait);
+    
+    std::atomic<bool> kernel_profiling_{false};
+    std::mutex kernel_mutex_;
+    std::vector<PendingLaunch> pending_;
+    std::map<std::string, KernelStats> kernel_stats_;
+    double peak_gb_per_s_ = 0.0;
+    double peak_gflop_per_s_ = 0.0;
 };
 
 } // namespace ocl
@@ -1,13 +1,65 @@
 #pragma once
 
 #include <ocl/Errors.hpp>
+#include <ocl/Types.hpp>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace ocl {
 
 // Forward declarations
 class Context;
 class Device;
+struct KernelSource;
+struct KernelInfo;
+
+// ============================================================================
+// Define - compile-time constant injected as -D<name>=<value>
+// ============================================================================
+
+class Define {
+public:
+    // Usage: Define("TILE_SIZE", 32), Define("T", "double")
+    Define(std::string name, const char* value) : name_(std::move(name)), value_(value) {}
+    Define(std::string name, std::string value) : name_(std::move(name)), value_(std::move(value)) {}
+    
+    template<typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    Define(std::string name, T value) : name_(std::move(name)), value_(format(value)) {}
+    
+    const std::string& name() const { return name_; }
+    const std::string& value() const { return value_; }
+    
+    // Build option form: -DNAME=VALUE
+    std::string toOption() const { return "-D" + name_ + "=" + value_; }
+    
+private:
+    std::string name_;
+    std::string value_;
+    
+    template<typename T>
+    static std::string format(T value) {
+        std::ostringstream out;
+        if (std::is_floating_point<T>::value) {
+            out.precision(std::numeric_limits<T>::max_digits10);
+            out << value;
+            // Make sure the literal is floating point, and keep
+            // single-precision constants single precision in OpenCL C
+            if (out.str().find_first_of(".e") == std::string::npos) out << ".0";
+            if (std::is_same<T, float>::value) out << 'f';
+        } else {
+            out << +value;  // Promote chars so they print as numbers
+        }
+        return out.str();
+    }
+};
+
+using Definitions = std::vector<Define>;
 
 // ============================================================================
 // Program - manages OpenCL program with RAII
@@ -21,6 +73,25 @@ public:
     // Create program from file
     static Program fromFile(const Context& context, const std::string& filepath);
     
+    // Create program from a source embedded at build time (see ocl_embed_kernels)
+    // Usage: Program prog = Program::fromEmbedded(ctx, "vector_add.cl");
+    static Program fromEmbedded(const Context& context, const std::string& name);
+    
+    // Create program from SPIR-V, skipping the OpenCL C front end. Uses
+    // clCreateProgramWithIL on OpenCL 2.1+ and cl_khr_il_program otherwise
+    // (see Device::supportsIL). Build options like -D have no effect on IL.
+    // Usage: Program prog = Program::fromIL(ctx, spirv); prog.build(device);
+    static Program fromIL(const Context& context, const void* il, size_t size);
+    static Program fromIL(const Context& context, const std::vector<unsigned char>& il);
+    static Program fromILFile(const Context& context, const std::string& filepath);
+    
+    // Create and build an embedded program. Prefers, in order: a precompiled
+    // binary for this device, embedded SPIR-V (if the device accepts IL),
+    // and the embedded source. Non-empty options always build the source,
+    // since the binary and SPIR-V forms were compiled without them.
+    static Program buildEmbedded(const Context& context, const Device& device, const std::string& name,
+                                 const std::string& options = "");
+    
     ~Program();
     
     // Disable copying
@@ -34,14 +105,60 @@ public:
     // Build program
     void build(const Device& device, const std::string& options = "");
     
+    // Off by default: have build() warn on stderr about kernels that spill
+    // registers, where the driver reports it (costs a kernel query per build)
+    static void setSpillWarnings(bool enabled);
+    static bool getSpillWarnings();
+    
+    // Resource report of every kernel in the built program
+    std::vector<KernelInfo> getKernelInfo(const Device& device) const;
+    
     // Save compiled binary to file
     void saveBinary(const Device& device, const std::string& filepath);
     
     // Load program from binary file
     static Program fromBinary(const Context& context, const Device& device, const std::string& filepath);
     
-    // Build with optimization flags
-    void buildOptimized(const Device& device);
+    // Load program from a binary in memory
+    static Program fromBinary(const Context& context, const Device& device, const unsigned char* binary, size_t size);
+    
+    // Build a flattened source (see SourceLoader) through an on-disk binary
+    // cache. Entries are keyed by the source's dependency hash, the options
+    // and the device/driver, so editing any included header invalidates
+    // them. Sources with unresolved includes (left to the compiler's -I
+    // paths) bypass the cache. cache_dir "" uses $OCL_BINARY_CACHE, or
+    // builds without caching.
+    static Program buildCached(const Context& context, const Device& device, const KernelSource& source,
+                               const std::string& options = "", const std::string& cache_dir = "");
+    
+    // Build with optimization flags (extra options are appended)
+    void buildOptimized(const Device& device, const std::string& extra_options = "");
+    
+    // Optimization flags used by buildOptimized()
+    static std::string getOptimizedOptions();
+    
+    // Build (once) and return a variant of this program's source with the
+    // given definitions injected as -D options. Variants are cached by their
+    // (order-independent) definitions and options, built for every device in
+    // the program's context, and the returned reference stays valid.
+    // Usage: Program& p = prog.specialize({{"TILE_SIZE", 32}, {"T", "double"}});
+    Program& specialize(const Definitions& definitions, const std::string& options = "");
+    
+    // Same as specialize(), with T defined as the OpenCL name of ElemT
+    // Usage: Program& p = prog.specializeFor<double>({{"TILE_SIZE", 32}});
+    template<typename ElemT>
+    Program& specializeFor(Definitions definitions = {}, const std::string& options = "") {
+        definitions.emplace_back("T", typeName<ElemT>());
+        return specialize(definitions, options);
+    }
+    
+    // Hash identifying a set of definitions and options (order-independent),
+    // e.g. for logs or file names. Not the variant cache key: specialize()
+    // keys on the full string, so distinct sets never share an entry
+    static uint64_t hashDefinitions(const Definitions& definitions, const std::string& options = "");
+    
+    // Number of cached specializations
+    size_t getVariantCount() const;
     
     // Build with debug flags
     void buildDebug(const Device& device);
@@ -53,7 +170,10 @@ public:
     cl_program get() const { return program_; }
     
 private:
+    struct VariantCache;
+    
     cl_program program_;
+    std::unique_ptr<VariantCache> variants_;
 };
 
 } // namespace ocl
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <ocl/Errors.hpp>
+#include <ocl/CommandQueue.hpp>
+#include <ocl/Event.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ocl {
+
+// Forward declarations
+class Context;
+class Device;
+
+// How QueuePool::submit() picks a queue
+enum class QueueAssignment {
+    Pinned,       // Each thread always uses the same queue (round-robin on first use)
+    LeastLoaded   // Queue with the fewest in-flight submissions
+};
+
+// Per-queue statistics
+struct QueueMetrics {
+    size_t depth;                 // Submissions whose last command has not completed
+    uint64_t submissions;         // Total submissions
+    double mean_submit_us;        // Mean host time spent enqueueing a submission
+    double max_submit_us;
+};
+
+// ============================================================================
+// QueuePool - several in-order queues on one device for multi-threaded submission
+// ============================================================================
+
+// Usage:
+//   QueuePool pool(ctx, device, 4);
+//   Event done = pool.submit([&](CommandQueue& q) {
+//       kernel->execute(q, global, local);
+//       return q.enqueueMarker();
+//   });
+class QueuePool {
+public:
+    QueuePool(const Context& context, const Device& device, size_t count = 4,
+              QueueAssignment assignment = QueueAssignment::Pinned,
+              cl_command_queue_properties properties = 0);
+    ~QueuePool();
+    
+    // Disable copying and moving (completion callbacks point into the pool)
+    QueuePool(const QueuePool&) = delete;
+    QueuePool& operator=(const QueuePool&) = delete;
+    
+    // Enqueue work on a queue chosen by the assignment policy. `enqueue` is
+    // called as Event(CommandQueue&) and returns the event of its last
+    // command (an invalid Event means "everything enqueued", and a marker
+    // is added). Commands wait for `after`, which may come from other queues.
+    template<typename F>
+    Event submit(F&& enqueue, const std::vector<Event>& after = {}) {
+        const size_t index = select();
+        Slot& slot = *slots_[index];
+        
+        const auto start = std::chrono::steady_clock::now();
+        if (!after.empty()) {
+            slot.queue.enqueueBarrier(after);
+        }
+        Event event = std::forward<F>(enqueue)(slot.queue);
+        if (!event.isValid()) {
+            event = slot.queue.enqueueMarker();
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        
+        track(slot, event, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        return event;
+    }
+    
+    // Queue the calling thread would be assigned now
+    CommandQueue& queue() { return slots_[select()]->queue; }
+    CommandQueue& queue(size_t index) { return slots_.at(index)->queue; }
+    size_t size() const { return slots_.size(); }
+    
+    // Flush or finish every queue
+    void flush();
+    void finish();
+    
+    QueueMetrics getMetrics(size_t index) const;
+    std::vector<QueueMetrics> getMetrics() const;
+    
+private:
+    struct Slot {
+        CommandQueue queue;
+        std::atomic<size_t> depth{0};
+        std::atomic<uint64_t> submissions{0};
+        std::atomic<uint64_t> submit_ns{0};
+        std::atomic<uint64_t> max_submit_ns{0};
+    };
+    
+    size_t select() const;
+    void track(Slot& slot, const Event& event, int64_t submit_ns);
+    static void CL_CALLBACK onComplete(cl_event event, cl_int status, void* slot);
+    
+    QueueAssignment assignment_;
+    std::vector<std::unique_ptr<Slot>> slots_;
+};
+
+} // namespace ocl
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <ocl/Errors.hpp>
+#include <cstddef>
+#include <cstdint>
+
+// Handles the release queue holds before releases fall back to inline
+// (power of two)
+#ifndef OCL_RELEASE_QUEUE_SIZE
+#define OCL_RELEASE_QUEUE_SIZE 4096
+#endif
+
+namespace ocl {
+
+// Forward declaration
+class Event;
+
+// ============================================================================
+// Reclaimer - deferred release of OpenCL handles off the calling thread
+// ============================================================================
+
+// Usage:
+//   ocl::Reclaimer::setMode(ocl::ReleaseMode::Deferred);
+//   {
+//       ocl::Buffer<float> tmp(ctx, N);
+//       ...
+//   }   // ~Buffer queues the handle; a background thread releases it
+//
+//   // Keep a buffer alive until a kernel that reads it has finished, then
+//   // drop that reference from the background thread
+//   ocl::Reclaimer::holdUntil(kernel_done, tmp);
+//
+// Some drivers block in clRelease* until the commands using the object
+// have completed. In Deferred mode the Buffer, Kernel, Program and Event
+// destructors push their handle onto a bounded lock-free queue instead,
+// so the calling thread never waits; if the queue is full the handle is
+// released inline. Context and CommandQueue are always released inline.
+
+enum class ReleaseMode {
+    Immediate,  // clRelease* in the destructor (default)
+    Deferred    // Queued for the background thread
+};
+
+class Reclaimer {
+public:
+    // Switching to Deferred starts the background thread; switching back
+    // leaves already queued handles to it
+    static void setMode(ReleaseMode mode);
+    static ReleaseMode getMode();
+    
+    // Release everything queued before the call, on this thread if needed
+    static void flush();
+    
+    // Handles queued but not yet released
+    static size_t getPendingCount();
+    
+    // Total handles released by the background thread or flush()
+    static uint64_t getReleasedCount();
+    
+    // Take another reference to object (a Buffer, Kernel, Program or Event)
+    // and release it from the background thread once event completes or
+    // fails, independent of the release mode. The object itself can then go
+    // out of scope: dropping a reference that is not the last never blocks.
+    template<typename T>
+    static void holdUntil(const Event& event, const T& object) {
+        hold(event, object.get());
+    }
+    
+private:
+    static void hold(const Event& event, cl_mem mem);
+    static void hold(const Event& event, cl_kernel kernel);
+    static void hold(const Event& event, cl_program program);
+    static void hold(const Event& event, cl_event other);
+};
+
+// Release hooks for the RAII wrappers: inline or queued per the mode
+namespace detail {
+    void releaseMemObject(cl_mem mem);
+    void releaseKernel(cl_kernel kernel);
+    void releaseProgram(cl_program program);
+    void releaseEvent(cl_event event);
+}
+
+} // namespace ocl
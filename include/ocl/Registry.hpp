@@ -1,14 +1,49 @@
 #pragma once
 
+#include <ocl/Device.hpp>
 #include <ocl/Errors.hpp>
+#include <map>
+#include <string>
 #include <vector>
 
 namespace ocl {
 
 // Forward declarations
-class Device;
 class Platform;
 
+// ============================================================================
+// DevicePolicy - requirements and ranking for Registry::selectDevice
+// ============================================================================
+
+struct DevicePolicy {
+    enum class Ranking {
+        Capabilities,  // Declared compute units x clock x float vector width
+        Measured       // Triad bandwidth and FMA throughput probes, cached on disk
+    };
+    
+    Ranking ranking = Ranking::Capabilities;
+    
+    // Filters
+    cl_device_type type = CL_DEVICE_TYPE_ALL;
+    std::vector<std::string> extensions;  // All required
+    cl_ulong min_global_mem = 0;          // Bytes
+    cl_uint min_version = 0;              // e.g. 200 for OpenCL 2.0
+    bool require_fp64 = false;
+    
+    // Measured ranking: score = GB/s^w x GFLOP/s^(1-w)
+    double bandwidth_weight = 0.5;
+    std::string cache_path;  // "" = $OCL_DEVICE_CACHE, else ~/.cache/ocl_device_scores.tsv (or $TMPDIR)
+};
+
+struct DeviceScore {
+    Device device;
+    bool eligible = false;
+    std::string reason;        // Why the device was filtered out (or "probe failed: ...")
+    double score = 0.0;        // Higher is better
+    double gb_per_s = 0.0;     // Measured ranking only
+    double gflop_per_s = 0.0;
+};
+
 // ============================================================================
 // Registry - Central registry for OpenCL platforms and devices
 // ============================================================================
@@ -33,12 +68,30 @@ public:
     // Get default device (first GPU, or first device)
     Device getDefaultDevice() const;
     
+    // Best eligible device under `policy`. Environment overrides:
+    //   OCL_DEVICE=<index | platform:index | name substring>  pick a device
+    //     (a selector of digits, or digits:digits, is never a name)
+    //   OCL_DEVICE_TYPE=gpu|cpu|accelerator|all               narrow the type
+    // A forced device must still meet the policy's requirements.
+    // Usage: DevicePolicy policy;
+    //        policy.ranking = DevicePolicy::Ranking::Measured;
+    //        policy.require_fp64 = true;
+    //        Device device = Registry::instance().selectDevice(policy);
+    Device selectDevice(const DevicePolicy& policy = DevicePolicy()) const;
+    
+    // Every device with its score, eligible ones first and best first
+    std::vector<DeviceScore> rankDevices(const DevicePolicy& policy = DevicePolicy()) const;
+    
     // Get platform by index
     const Platform& getPlatform(size_t index) const;
     
     // Get device count
     size_t getDeviceCount() const;
     
+    // Describe a device and its platform/driver as key/value pairs
+    // (recorded with benchmark results so runs can be compared)
+    std::map<std::string, std::string> getDeviceMetadata(const Device& device) const;
+    
     // Print registry info
     void printInfo() const;
     
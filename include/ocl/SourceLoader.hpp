@@ -0,0 +1,67 @@
+#pragma once
+
+#include <ocl/Errors.hpp>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ocl {
+
+// ============================================================================
+// SourceLoader - kernel sources with #include dependencies resolved
+// ============================================================================
+
+// A kernel source flattened into one translation unit
+struct KernelSource {
+    std::string name;                       // Top-level file path or embedded name
+    std::string text;                       // Includes inlined, with #line markers
+    std::vector<std::string> dependencies;  // Resolved includes, in order of first use
+    std::vector<std::string> unresolved;    // Left in place for the compiler's -I paths
+    uint64_t hash = 0;                      // Over the flattened text, i.e. every dependency
+    
+    std::string getHashString() const;      // 16 hex digits
+};
+
+// Resolves #include "..." and #include <...> in this order: the including
+// file's directory (quoted form only), the registered directories, then
+// embedded files (see ocl_embed_kernels HEADERS). Headers with
+// #pragma once are inlined once. Conditionals are not evaluated, so an
+// include that cannot be found is kept as-is rather than reported.
+// Usage:
+//   SourceLoader loader;
+//   loader.addIncludeDirectory("kernels/common");
+//   KernelSource source = loader.loadFile("kernels/filter.cl");
+//   Program prog = Program::buildCached(ctx, device, source, "-DRADIUS=3", "cache");
+class SourceLoader {
+public:
+    void addIncludeDirectory(const std::string& directory);
+    const std::vector<std::string>& getIncludeDirectories() const { return directories_; }
+    
+    // Search embedded files for includes (on by default)
+    void setSearchEmbedded(bool enabled) { search_embedded_ = enabled; }
+    
+    KernelSource loadFile(const std::string& path) const;
+    KernelSource loadEmbedded(const std::string& name) const;
+    
+    // Source held in memory; quoted includes resolve against `directory`
+    KernelSource load(const std::string& name, const std::string& text, const std::string& directory = "") const;
+    
+private:
+    struct Expansion {
+        KernelSource* result;
+        std::vector<std::string> stack;  // Files being expanded (cycle detection)
+        std::set<std::string> once;      // Files with #pragma once already inlined
+    };
+    
+    // Find an include; `id` is a path or "embedded:<name>"
+    bool resolve(const std::string& include, bool quoted, const std::string& directory,
+                 std::string& id, std::string& text) const;
+    void expand(const std::string& id, const std::string& text, const std::string& directory,
+                Expansion& expansion, std::string& out) const;
+    
+    std::vector<std::string> directories_;
+    bool search_embedded_ = true;
+};
+
+} // namespace ocl
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <ocl/Errors.hpp>
+#include <string>
+
+namespace ocl {
+
+// Forward declaration
+template<typename T> class Buffer;
+
+// ============================================================================
+// TypeName - maps host types to OpenCL C type names
+// ============================================================================
+
+// Unsupported types fail to compile (no primary definition)
+template<typename T> struct TypeName;
+
+template<> struct TypeName<char>      { static std::string name() { return "char"; } };
+template<> struct TypeName<cl_char>   { static std::string name() { return "char"; } };
+template<> struct TypeName<cl_uchar>  { static std::string name() { return "uchar"; } };
+template<> struct TypeName<cl_short>  { static std::string name() { return "short"; } };
+template<> struct TypeName<cl_ushort> { static std::string name() { return "ushort"; } };
+template<> struct TypeName<cl_int>    { static std::string name() { return "int"; } };
+template<> struct TypeName<cl_uint>   { static std::string name() { return "uint"; } };
+template<> struct TypeName<cl_long>   { static std::string name() { return "long"; } };
+template<> struct TypeName<cl_ulong>  { static std::string name() { return "ulong"; } };
+template<> struct TypeName<cl_float>  { static std::string name() { return "float"; } };
+template<> struct TypeName<cl_double> { static std::string name() { return "double"; } };
+
+// Buffer<T> is passed to kernels as a pointer to T
+template<typename T> struct TypeName<Buffer<T>> {
+    static std::string name() { return TypeName<T>::name() + "*"; }
+};
+
+// Usage: typeName<float>() == "float", typeName<Buffer<int>>() == "int*"
+template<typename T>
+std::string typeName() {
+    return TypeName<T>::name();
+}
+
+} // namespace ocl
@@ -4,14 +4,29 @@
 // Main header that includes all modules
 
 #include <ocl/Errors.hpp>
+#include <ocl/Types.hpp>
 #include <ocl/Platform.hpp>
 #include <ocl/Device.hpp>
 #include <ocl/Context.hpp>
 #include <ocl/CommandQueue.hpp>
+#include <ocl/QueuePool.hpp>
 #include <ocl/Event.hpp>
+#include <ocl/Executor.hpp>
+#include <ocl/Async.hpp>
 #include <ocl/Program.hpp>
 #include <ocl/Kernel.hpp>
+#include <ocl/KernelFunctor.hpp>
+#include <ocl/KernelPool.hpp>
+#include <ocl/KernelCache.hpp>
 #include <ocl/Buffer.hpp>
 #include <ocl/NDRange.hpp>
 #include <ocl/Profiler.hpp>
+#include <ocl/Benchmark.hpp>
+#include <ocl/Metrics.hpp>
+#include <ocl/Instrument.hpp>
 #include <ocl/Registry.hpp>
+#include <ocl/ElementWise.hpp>
+#include <ocl/Embedded.hpp>
+#include <ocl/SourceLoader.hpp>
+#include <ocl/Reclaimer.hpp>
+#include <ocl/EventTracker.hpp>
@@ -1,10 +1,23 @@
 // Tiled matrix multiplication for better performance
+//
+// Specializable via Program::specialize(): TILE_SIZE (work-group is
+// TILE_SIZE x TILE_SIZE) and element type T.
 
+#ifndef TILE_SIZE
 #define TILE_SIZE 16
+#endif
 
-__kernel void matmul_tiled(__global const float* A,
-                          __global const float* B,
-                          __global float* C,
+#ifndef T
+#define T float
+#endif
+
+#ifdef cl_khr_fp64
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#endif
+
+__kernel void matmul_tiled(__global const T* A,
+                          __global const T* B,
+                          __global T* C,
                           const int M,
                           const int K,
                           const int N) {
@@ -16,11 +29,11 @@ __kernel void matmul_tiled(__global const float* A,
     const int globalCol = TILE_SIZE * get_group_id(1) + col;
     
     // Local memory for tiles
-    __local float Asub[TILE_SIZE][TILE_SIZE];
-    __local float Bsub[TILE_SIZE][TILE_SIZE];
+    __local T Asub[TILE_SIZE][TILE_SIZE];
+    __local T Bsub[TILE_SIZE][TILE_SIZE];
     
     // Accumulator
-    float sum = 0.0f;
+    T sum = 0;
     
     // Loop over tiles
     const int numTiles = (K + TILE_SIZE - 1) / TILE_SIZE;
@@ -32,7 +45,7 @@ __kernel void matmul_tiled(__global const float* A,
         if (tiledRow < M && tiledCol < K) {
             Asub[row][col] = A[tiledRow * K + tiledCol];
         } else {
-            Asub[row][col] = 0.0f;
+            Asub[row][col] = 0;
         }
         
         // Load tile from B
@@ -41,7 +54,7 @@ __kernel void matmul_tiled(__global const float* A,
         if (tiledRow2 < K && tiledCol2 < N) {
             Bsub[row][col] = B[tiledRow2 * N + tiledCol2];
         } else {
-            Bsub[row][col] = 0.0f;
+            Bsub[row][col] = 0;
         }
         
         // Synchronize to make sure tiles are loaded
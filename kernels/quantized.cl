@@ -0,0 +1,117 @@
+// Quantized int8 kernels - affine quantization and int8 x int8 -> int32 GEMM
+//
+// Scheme: q = clamp(round(x / scale) + zero_point, -128, 127)
+//         x = (q - zero_point) * scale
+//
+// GEMM layout: A is M x K (activations, one scale/zero point for the tensor),
+// B is N x K (weights, one row per output channel with its own scale/zero
+// point). Storing B by output channel keeps both operands contiguous in K so
+// they can be consumed four bytes at a time.
+
+#if defined(cl_khr_integer_dot_product) && defined(__opencl_c_integer_dot_product_input_4x8bit)
+#define HAS_INTEGER_DOT_PRODUCT 1
+#endif
+
+// 4-wide int8 dot product accumulated in int32
+inline int dot_char4(char4 a, char4 b) {
+#ifdef HAS_INTEGER_DOT_PRODUCT
+    return dot(a, b);
+#else
+    int4 p = convert_int4(a) * convert_int4(b);
+    return (p.x + p.y) + (p.z + p.w);
+#endif
+}
+
+// Quantize floats to int8 - element i belongs to channel i / channel_size
+// (pass channel_size = n with single-element scale/zero_point for per-tensor)
+__kernel void quantize(__global const float* input,
+                       __global char* output,
+                       __global const float* scale,
+                       __global const int* zero_point,
+                       const int channel_size,
+                       const int n) {
+    int i = get_global_id(0);
+    if (i < n) {
+        int c = i / channel_size;
+        int q = convert_int_rte(input[i] / scale[c]) + zero_point[c];
+        output[i] = convert_char_sat(q);
+    }
+}
+
+// Dequantize int8 back to floats (same channel layout as quantize)
+__kernel void dequantize(__global const char* input,
+                         __global float* output,
+                         __global const float* scale,
+                         __global const int* zero_point,
+                         const int channel_size,
+                         const int n) {
+    int i = get_global_id(0);
+    if (i < n) {
+        int c = i / channel_size;
+        output[i] = (float)((int)input[i] - zero_point[c]) * scale[c];
+    }
+}
+
+// C[m][n] = sum_k (A[m][k] - a_zero) * (B[n][k] - b_zero[n])
+//
+// Zero points are folded out of the inner loop:
+//   sum(a*b) - zb*sum(a) - za*sum(b) + K*za*zb
+__kernel void gemm_int8(__global const char* A,
+                        __global const char* B,
+                        __global int* C,
+                        const int M,
+                        const int N,
+                        const int K,
+                        const int a_zero,
+                        __global const int* b_zero) {
+    
+    const int row = get_global_id(0);
+    const int col = get_global_id(1);
+    if (row >= M || col >= N) {
+        return;
+    }
+    
+    __global const char* a = A + row * K;
+    __global const char* b = B + col * K;
+    const char4 ones = (char4)(1);
+    
+    int sum_ab = 0;
+    int sum_a = 0;
+    int sum_b = 0;
+    
+    // Packed char4 main loop
+    int k = 0;
+    for (; k + 4 <= K; k += 4) {
+        char4 va = vload4(0, a + k);
+        char4 vb = vload4(0, b + k);
+        sum_ab += dot_char4(va, vb);
+        sum_a += dot_char4(va, ones);
+        sum_b += dot_char4(vb, ones);
+    }
+    
+    // Scalar tail
+    for (; k < K; k++) {
+        int va = a[k];
+        int vb = b[k];
+        sum_ab += va * vb;
+        sum_a += va;
+        sum_b += vb;
+    }
+    
+    const int b_zp = b_zero[col];
+    C[row * N + col] = sum_ab - b_zp * sum_a - a_zero * sum_b + K * a_zero * b_zp;
+}
+
+// Convert int32 accumulators to floats: out = acc * a_scale * b_scale[n]
+__kernel void dequantize_gemm(__global const int* acc,
+                              __global float* output,
+                              const float a_scale,
+                              __global const float* b_scale,
+                              const int M,
+                              const int N) {
+    const int row = get_global_id(0);
+    const int col = get_global_id(1);
+    if (row < M && col < N) {
+        output[row * N + col] = (float)acc[row * N + col] * (a_scale * b_scale[col]);
+    }
+}
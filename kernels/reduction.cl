@@ -28,3 +28,45 @@ __kernel void reduce_sum(__global const float* input,
     }
 }
 
+
+// Sub-group reduction - same interface as reduce_sum, but each sub-group
+// reduces in registers and only one barrier is needed to combine them.
+// Requires cl_khr_subgroups (build with -cl-std=CL2.0).
+
+#if defined(cl_khr_subgroups) || defined(__opencl_c_subgroups)
+#ifdef cl_khr_subgroups
+#pragma OPENCL EXTENSION cl_khr_subgroups : enable
+#endif
+
+__kernel void reduce_sum_subgroup(__global const float* input,
+                                  __global float* output,
+                                  __local float* scratch,
+                                  const int length) {
+    
+    int global_id = get_global_id(0);
+    
+    // Reduce within each sub-group (no local memory, no barrier)
+    float value = (global_id < length) ? input[global_id] : 0.0f;
+    float sum = sub_group_reduce_add(value);
+    if (get_sub_group_local_id() == 0) {
+        scratch[get_sub_group_id()] = sum;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+    
+    // First sub-group combines the per-sub-group partial sums
+    if (get_sub_group_id() == 0) {
+        uint num_partials = get_num_sub_groups();
+        float partial = 0.0f;
+        for (uint i = get_sub_group_local_id(); i < num_partials; i += get_sub_group_size()) {
+            partial += scratch[i];
+        }
+        sum = sub_group_reduce_add(partial);
+        
+        // Write result for this work-group
+        if (get_sub_group_local_id() == 0) {
+            output[get_group_id(0)] = sum;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,40 @@
+// Roofline calibration kernels: one bound by memory bandwidth, one by
+// floating-point throughput. Used by the roofline example to measure the
+// device's attainable peaks.
+
+// STREAM triad: a = b + scalar * c
+// 12 bytes moved and 2 FLOPs per element (intensity 1/6 FLOP/byte)
+__kernel void stream_triad(__global float* a,
+                           __global const float* b,
+                           __global const float* c,
+                           const float scalar,
+                           const int n) {
+    int i = get_global_id(0);
+    if (i < n) {
+        a[i] = b[i] + scalar * c[i];
+    }
+}
+
+// FMA throughput: four independent float4 chains kept in registers
+// 32 FLOPs per iteration per work-item; one store keeps the work alive
+__kernel void fma_peak(__global float* out,
+                       const float seed,
+                       const int iterations) {
+    const float4 mul = (float4)(0.999f);
+    const float4 add = (float4)(0.001f);
+    
+    float4 x0 = (float4)(seed + get_global_id(0));
+    float4 x1 = x0 + 1.0f;
+    float4 x2 = x0 + 2.0f;
+    float4 x3 = x0 + 3.0f;
+    
+    for (int i = 0; i < iterations; i++) {
+        x0 = fma(x0, mul, add);
+        x1 = fma(x1, mul, add);
+        x2 = fma(x2, mul, add);
+        x3 = fma(x3, mul, add);
+    }
+    
+    float4 sum = x0 + x1 + x2 + x3;
+    out[get_global_id(0)] = sum.x + sum.y + sum.z + sum.w;
+}
@@ -54,3 +54,60 @@ __kernel void scan_inclusive(__global const float* input,
     if (bi < n) output[bi] = temp[bi];
 }
 
+
+// Sub-group prefix sum - same interface and launch as scan_inclusive
+// (n/2 work-items, exclusive result), built on sub_group_scan_exclusive_add
+// so only two local-memory barriers remain instead of 2*log2(n).
+// Requires cl_khr_subgroups (build with -cl-std=CL2.0).
+
+#if defined(cl_khr_subgroups) || defined(__opencl_c_subgroups)
+#ifdef cl_khr_subgroups
+#pragma OPENCL EXTENSION cl_khr_subgroups : enable
+#endif
+
+__kernel void scan_subgroup(__global const float* input,
+                            __global float* output,
+                            __local float* temp,
+                            const int n) {
+    
+    int thid = get_local_id(0);
+    
+    // Each work-item owns two consecutive elements
+    int ai = 2 * thid;
+    int bi = 2 * thid + 1;
+    float a = (ai < n) ? input[ai] : 0.0f;
+    float b = (bi < n) ? input[bi] : 0.0f;
+    
+    // Exclusive scan of pair sums within the sub-group
+    float prefix = sub_group_scan_exclusive_add(a + b);
+    
+    // Last lane publishes the sub-group total
+    uint sg = get_sub_group_id();
+    if (get_sub_group_local_id() == get_sub_group_size() - 1) {
+        temp[sg] = prefix + a + b;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+    
+    // First sub-group turns the totals into per-sub-group offsets
+    if (sg == 0) {
+        uint count = get_num_sub_groups();
+        float carry = 0.0f;
+        for (uint base = 0; base < count; base += get_sub_group_size()) {
+            uint i = base + get_sub_group_local_id();
+            float total = (i < count) ? temp[i] : 0.0f;
+            float offset = sub_group_scan_exclusive_add(total);
+            if (i < count) {
+                temp[i] = carry + offset;
+            }
+            carry += sub_group_reduce_add(total);
+        }
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+    
+    // Write results
+    float offset = temp[sg] + prefix;
+    if (ai < n) output[ai] = offset;
+    if (bi < n) output[bi] = offset + a;
+}
+
+#endif
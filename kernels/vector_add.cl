@@ -1,7 +1,16 @@
-// Simple vector addition kernel
-__kernel void vector_add(__global const float* a,
-                        __global const float* b,
-                        __global float* c,
+// Simple vector addition kernel (element type T, float by default)
+
+#ifndef T
+#define T float
+#endif
+
+#ifdef cl_khr_fp64
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#endif
+
+__kernel void vector_add(__global const T* a,
+                        __global const T* b,
+                        __global T* c,
                         const int n) {
     int i = get_global_id(0);
     if (i < n) {
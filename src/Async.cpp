@@ -0,0 +1,115 @@
+#include <ocl/Async.hpp>
+#include <ocl/Context.hpp>
+#include <atomic>
+
+namespace ocl {
+
+namespace {
+
+// Owned by the OpenCL runtime between registration and the callback
+struct Completion {
+    Event event;   // Keeps the event alive until the callback has run
+    std::function<void(cl_int)> callback;
+    Executor* executor;
+};
+
+void CL_CALLBACK onEventComplete(cl_event, cl_int status, void* data) {
+    std::unique_ptr<Completion> completion(static_cast<Completion*>(data));
+    if (completion->executor) {
+        auto callback = std::move(completion->callback);
+        completion->executor->execute([callback, status] { callback(status); });
+    } else {
+        completion->callback(status);
+    }
+}
+
+} // namespace
+
+void onComplete(const Event& event, std::function<void(cl_int)> callback, Executor* executor) {
+    if (!event.isValid()) {
+        throw std::runtime_error("Cannot wait on invalid event");
+    }
+    
+    std::unique_ptr<Completion> completion(new Completion{event.retain(), std::move(callback), executor});
+    cl_int err = clSetEventCallback(event.get(), CL_COMPLETE, onEventComplete, completion.get());
+    checkError(err, "setting event callback");
+    completion.release();  // Freed by onEventComplete
+}
+
+std::future<void> toFuture(const Event& event) {
+    auto promise = std::make_shared<std::promise<void>>();
+    std::future<void> future = promise->get_future();
+    
+    onComplete(event, [promise](cl_int status) {
+        if (status < 0) {
+            promise->set_exception(std::make_exception_ptr(Error(status, "waiting for event")));
+        } else {
+            promise->set_value();
+        }
+    });
+    return future;
+}
+
+namespace {
+
+// Shared by the dependency callbacks of one host task
+struct HostTask {
+    Event done;
+    std::function<void()> task;
+    Executor* executor;
+    std::atomic<size_t> remaining;
+    std::atomic<bool> failed;
+    
+    HostTask(Event event, std::function<void()> fn, Executor* ex, size_t count)
+        : done(std::move(event)), task(std::move(fn)), executor(ex), remaining(count), failed(false) {}
+};
+
+void runHostTask(const std::shared_ptr<HostTask>& host) {
+    host->executor->execute([host] {
+        cl_int status = CL_COMPLETE;
+        if (host->failed.load(std::memory_order_acquire)) {
+            status = CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST;
+        } else {
+            try {
+                host->task();
+            } catch (...) {
+                status = CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST;
+            }
+        }
+        clSetUserEventStatus(host->done.get(), status);
+    });
+}
+
+} // namespace
+
+Event hostTask(const Context& context, Executor& executor, const std::vector<Event>& after,
+               std::function<void()> task) {
+    Event done = Event::createUser(context);
+    
+    size_t count = 0;
+    for (const auto& event : after) {
+        if (event.isValid()) ++count;
+    }
+    auto host = std::make_shared<HostTask>(done.retain(), std::move(task), &executor, count);
+    
+    if (count == 0) {
+        runHostTask(host);
+        return done;
+    }
+    
+    // The last dependency to complete schedules the task
+    for (const auto& event : after) {
+        if (!event.isValid()) continue;
+        onComplete(event, [host](cl_int status) {
+            if (status < 0) {
+                host->failed.store(true, std::memory_order_release);
+            }
+            if (host->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                runHostTask(host);
+            }
+        });
+    }
+    return done;
+}
+
+} // namespace ocl
@@ -0,0 +1,515 @@
+#include <ocl/Benchmark.hpp>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace ocl {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Median of a sorted, non-empty range
+double sortedMedian(const std::vector<double>& sorted) {
+    const size_t n = sorted.size();
+    return n % 2 == 1 ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return sortedMedian(values);
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::ostringstream out;
+    for (char c : text) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+                } else {
+                    out << c;
+                }
+        }
+    }
+    return out.str();
+}
+
+std::string csvEscape(const std::string& text) {
+    if (text.find_first_of(",\"\n") == std::string::npos) {
+        return text;
+    }
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// Reader for the JSON written by Benchmark::writeJSON. Handles any
+// well-formed JSON; unknown keys and values are skipped.
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text_(text), pos_(0) {}
+    
+    // Calls onMember(key) for each key; the callback must consume the value
+    template<typename F>
+    void parseObject(F onMember) {
+        expect('{');
+        if (consume('}')) return;
+        do {
+            std::string key = parseString();
+            expect(':');
+            onMember(key);
+        } while (consume(','));
+        expect('}');
+    }
+    
+    template<typename F>
+    void parseArray(F onItem) {
+        expect('[');
+        if (consume(']')) return;
+        do {
+            onItem();
+        } while (consume(','));
+        expect(']');
+    }
+    
+    std::string parseString() {
+        expect('"');
+        std::string value;
+        while (pos_ < text_.size() && text_[pos_] != '"') {
+            char c = text_[pos_++];
+            if (c == '\\') {
+                if (pos_ >= text_.size()) break;
+                char esc = text_[pos_++];
+                switch (esc) {
+                    case 'n': value += '\n'; break;
+                    case 't': value += '\t'; break;
+                    case 'r': value += '\r'; break;
+                    case 'b': value += '\b'; break;
+                    case 'f': value += '\f'; break;
+                    case 'u':
+                        // Only the ASCII range is ever written
+                        value += static_cast<char>(std::stoi(text_.substr(pos_, 4), nullptr, 16));
+                        pos_ += 4;
+                        break;
+                    default: value += esc;
+                }
+            } else {
+                value += c;
+            }
+        }
+        expect('"');
+        return value;
+    }
+    
+    double parseNumber() {
+        skipSpace();
+        size_t used = 0;
+        double value = std::stod(text_.substr(pos_, 32), &used);
+        pos_ += used;
+        return value;
+    }
+    
+    bool isString() {
+        skipSpace();
+        return pos_ < text_.size() && text_[pos_] == '"';
+    }
+    
+    void skipValue() {
+        skipSpace();
+        if (pos_ >= text_.size()) fail();
+        switch (text_[pos_]) {
+            case '{': parseObject([this](const std::string&) { skipValue(); }); break;
+            case '[': parseArray([this] { skipValue(); }); break;
+            case '"': parseString(); break;
+            case 't': literal("true"); break;
+            case 'f': literal("false"); break;
+            case 'n': literal("null"); break;
+            default: parseNumber();
+        }
+    }
+    
+private:
+    void skipSpace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) ++pos_;
+    }
+    
+    bool consume(char c) {
+        skipSpace();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+    
+    void expect(char c) {
+        if (!consume(c)) fail();
+    }
+    
+    void literal(const char* word) {
+        const std::string expected(word);
+        if (text_.compare(pos_, expected.size(), expected) != 0) fail();
+        pos_ += expected.size();
+    }
+    
+    void fail() const {
+        throw std::runtime_error("Malformed JSON at offset " + std::to_string(pos_));
+    }
+    
+    const std::string& text_;
+    size_t pos_;
+};
+
+// Standard error of a median estimated from its MAD (1.2533 * sigma / sqrt(n))
+double medianStandardError(const BenchmarkResult& result) {
+    if (result.samples == 0) {
+        return 0.0;
+    }
+    const double sigma = result.mad_ms > 0.0 ? 1.4826 * result.mad_ms : result.stddev_ms;
+    return 1.2533 * sigma / std::sqrt(static_cast<double>(result.samples));
+}
+
+} // namespace
+
+Benchmark::Benchmark(BenchmarkConfig config) : config_(config) {}
+
+BenchmarkResult Benchmark::summarize(const std::string& name, std::vector<double> samples_ms, double outlier_threshold) {
+    BenchmarkResult result;
+    result.name = name;
+    if (samples_ms.empty()) {
+        return result;
+    }
+    
+    // Reject outliers relative to the median, in units of the scaled MAD
+    // (1.4826 * MAD estimates the standard deviation of normal data)
+    std::sort(samples_ms.begin(), samples_ms.end());
+    const double raw_median = sortedMedian(samples_ms);
+    std::vector<double> deviations;
+    deviations.reserve(samples_ms.size());
+    for (double x : samples_ms) {
+        deviations.push_back(std::fabs(x - raw_median));
+    }
+    const double raw_mad = median(deviations);
+    
+    std::vector<double> kept;
+    if (raw_mad > 0.0 && outlier_threshold > 0.0) {
+        const double limit = outlier_threshold * 1.4826 * raw_mad;
+        for (double x : samples_ms) {
+            if (std::fabs(x - raw_median) <= limit) {
+                kept.push_back(x);
+            }
+        }
+    } else {
+        kept = samples_ms;
+    }
+    
+    const size_t n = kept.size();
+    result.samples = n;
+    result.outliers = samples_ms.size() - n;
+    result.median_ms = sortedMedian(kept);
+    result.min_ms = kept.front();
+    result.max_ms = kept.back();
+    
+    deviations.clear();
+    double sum = 0.0;
+    for (double x : kept) {
+        deviations.push_back(std::fabs(x - result.median_ms));
+        sum += x;
+    }
+    result.mad_ms = median(deviations);
+    result.mean_ms = sum / n;
+    
+    double sq = 0.0;
+    for (double x : kept) {
+        sq += (x - result.mean_ms) * (x - result.mean_ms);
+    }
+    result.stddev_ms = n > 1 ? std::sqrt(sq / (n - 1)) : 0.0;
+    
+    // Distribution-free 95% CI of the median from order statistics
+    const double half_width = 1.96 * std::sqrt(static_cast<double>(n)) / 2.0;
+    long lo = static_cast<long>(std::floor(n / 2.0 - half_width));      // 1-based rank
+    long hi = static_cast<long>(std::ceil(1.0 + n / 2.0 + half_width)); // 1-based rank
+    lo = std::max(1L, std::min(lo, static_cast<long>(n)));
+    hi = std::max(1L, std::min(hi, static_cast<long>(n)));
+    result.ci_low_ms = kept[lo - 1];
+    result.ci_high_ms = kept[hi - 1];
+    
+    return result;
+}
+
+const BenchmarkResult& Benchmark::measure(const std::string& name, const std::function<double(bool&)>& sample,
+                                          double bytes, double flops) {
+    bool device_timing = false;
+    for (size_t i = 0; i < config_.warmup_iterations; ++i) {
+        sample(device_timing);
+    }
+    
+    // Adaptive sample count: stop once the median is known precisely
+    // enough, subject to the sample and time bounds
+    std::vector<double> samples;
+    BenchmarkResult result;
+    const auto start = Clock::now();
+    for (;;) {
+        samples.push_back(sample(device_timing));
+        
+        const size_t n = samples.size();
+        const double elapsed = elapsedMs(start);
+        if (n >= config_.max_samples || elapsed >= config_.max_time_ms) {
+            break;
+        }
+        if (n < config_.min_samples || elapsed < config_.min_time_ms) {
+            continue;
+        }
+        result = summarize(name, samples, config_.outlier_threshold);
+        const double precision = (result.ci_high_ms - result.ci_low_ms) / 2.0;
+        if (precision <= config_.target_precision * result.median_ms) {
+            break;
+        }
+    }
+    
+    result = summarize(name, samples, config_.outlier_threshold);
+    result.device_timing = device_timing;
+    result.bytes = bytes;
+    result.flops = flops;
+    results_.push_back(result);
+    
+    if (config_.print) {
+        printResult(std::cout, results_.back());
+    }
+    return results_.back();
+}
+
+const BenchmarkResult& Benchmark::run(const std::string& name, const std::function<void()>& func,
+                                      double bytes, double flops) {
+    return measure(name, [&func](bool& device_timing) {
+        device_timing = false;
+        const auto start = Clock::now();
+        func();
+        return elapsedMs(start);
+    }, bytes, flops);
+}
+
+const BenchmarkResult& Benchmark::runEvent(const std::string& name, const std::function<Event()>& func,
+                                           double bytes, double flops) {
+    bool profiling = true;  // Until the first event shows otherwise
+    return measure(name, [&func, &profiling](bool& device_timing) {
+        const auto start = Clock::now();
+        Event event = func();
+        event.wait();
+        const double host_ms = elapsedMs(start);
+        
+        if (profiling) {
+            try {
+                device_timing = true;
+                return event.getProfilingDurationMs();
+            } catch (const Error&) {
+                profiling = false;  // Queue without CL_QUEUE_PROFILING_ENABLE
+            }
+        }
+        device_timing = false;
+        return host_ms;
+    }, bytes, flops);
+}
+
+BenchmarkComparison Benchmark::compare(const BenchmarkResult& baseline, const BenchmarkResult& candidate,
+                                       double z_threshold, double min_change_pct) {
+    BenchmarkComparison comparison;
+    comparison.name = candidate.name;
+    comparison.baseline_ms = baseline.median_ms;
+    comparison.candidate_ms = candidate.median_ms;
+    if (baseline.median_ms <= 0.0) {
+        return comparison;
+    }
+    
+    const double diff = candidate.median_ms - baseline.median_ms;
+    comparison.change_pct = 100.0 * diff / baseline.median_ms;
+    
+    const double se_base = medianStandardError(baseline);
+    const double se_cand = medianStandardError(candidate);
+    const double se = std::sqrt(se_base * se_base + se_cand * se_cand);
+    comparison.z_score = se > 0.0 ? diff / se : (diff != 0.0 ? (diff > 0 ? HUGE_VAL : -HUGE_VAL) : 0.0);
+    
+    if (std::fabs(comparison.z_score) >= z_threshold && std::fabs(comparison.change_pct) >= min_change_pct) {
+        comparison.change = diff > 0 ? BenchmarkChange::Regression : BenchmarkChange::Improvement;
+    }
+    return comparison;
+}
+
+void Benchmark::printHeader(std::ostream& out) {
+    out << std::left << std::setw(34) << "Benchmark"
+        << std::right << std::setw(11) << "Median"
+        << std::setw(10) << "±CI"
+        << std::setw(8) << "MAD%"
+        << std::setw(6) << "n"
+        << std::setw(10) << "GB/s"
+        << std::setw(10) << "GFLOP/s" << "\n";
+    out << "──────────────────────────────────────────────────────────────────────────────────────────\n";
+}
+
+void Benchmark::printResult(std::ostream& out, const BenchmarkResult& result) {
+    const double ci = (result.ci_high_ms - result.ci_low_ms) / 2.0;
+    const double mad_pct = result.median_ms > 0 ? 100.0 * result.mad_ms / result.median_ms : 0.0;
+    
+    std::string name = result.name + (result.device_timing ? "" : " *");
+    out << std::left << std::setw(34) << name
+        << std::right << std::fixed << std::setprecision(4)
+        << std::setw(8) << result.median_ms << " ms"
+        << std::setw(10) << ci
+        << std::setprecision(1) << std::setw(8) << mad_pct
+        << std::setw(6) << result.samples;
+    if (result.bytes > 0) {
+        out << std::setprecision(1) << std::setw(10) << result.getGBPerSecond();
+    } else {
+        out << std::setw(10) << "-";
+    }
+    if (result.flops > 0) {
+        out << std::setprecision(1) << std::setw(10) << result.getGFLOPPerSecond();
+    } else {
+        out << std::setw(10) << "-";
+    }
+    out << "\n";
+}
+
+void Benchmark::writeJSON(std::ostream& out) const {
+    out << std::setprecision(9) << std::defaultfloat;
+    out << "{\n  \"metadata\": {";
+    bool first = true;
+    for (const auto& entry : metadata_) {
+        out << (first ? "\n" : ",\n") << "    \"" << jsonEscape(entry.first) << "\": \"" << jsonEscape(entry.second) << "\"";
+        first = false;
+    }
+    out << (metadata_.empty() ? "},\n" : "\n  },\n");
+    
+    out << "  \"benchmarks\": [";
+    for (size_t i = 0; i < results_.size(); ++i) {
+        const BenchmarkResult& r = results_[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"name\": \"" << jsonEscape(r.name) << "\""
+            << ", \"timing\": \"" << (r.device_timing ? "device" : "host") << "\""
+            << ", \"samples\": " << r.samples
+            << ", \"outliers\": " << r.outliers
+            << ", \"median_ms\": " << r.median_ms
+            << ", \"mad_ms\": " << r.mad_ms
+            << ", \"mean_ms\": " << r.mean_ms
+            << ", \"stddev_ms\": " << r.stddev_ms
+            << ", \"min_ms\": " << r.min_ms
+            << ", \"max_ms\": " << r.max_ms
+            << ", \"ci_low_ms\": " << r.ci_low_ms
+            << ", \"ci_high_ms\": " << r.ci_high_ms
+            << ", \"bytes\": " << r.bytes
+            << ", \"flops\": " << r.flops
+            << ", \"gb_per_s\": " << r.getGBPerSecond()
+            << ", \"gflop_per_s\": " << r.getGFLOPPerSecond() << "}";
+    }
+    out << (results_.empty() ? "]\n}\n" : "\n  ]\n}\n");
+}
+
+void Benchmark::writeCSV(std::ostream& out) const {
+    out << std::setprecision(9) << std::defaultfloat;
+    out << "name,timing,samples,outliers,median_ms,mad_ms,mean_ms,stddev_ms,min_ms,max_ms,"
+           "ci_low_ms,ci_high_ms,bytes,flops,gb_per_s,gflop_per_s\n";
+    for (const auto& r : results_) {
+        out << csvEscape(r.name) << ',' << (r.device_timing ? "device" : "host") << ','
+            << r.samples << ',' << r.outliers << ',' << r.median_ms << ',' << r.mad_ms << ','
+            << r.mean_ms << ',' << r.stddev_ms << ',' << r.min_ms << ',' << r.max_ms << ','
+            << r.ci_low_ms << ',' << r.ci_high_ms << ',' << r.bytes << ',' << r.flops << ','
+            << r.getGBPerSecond() << ',' << r.getGFLOPPerSecond() << "\n";
+    }
+}
+
+bool Benchmark::writeJSON(const std::string& filepath) const {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        return false;
+    }
+    writeJSON(file);
+    return file.good();
+}
+
+bool Benchmark::writeCSV(const std::string& filepath) const {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        return false;
+    }
+    writeCSV(file);
+    return file.good();
+}
+
+bool Benchmark::readJSON(const std::string& filepath) {
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string text = buffer.str();
+    
+    std::map<std::string, std::string> metadata;
+    std::vector<BenchmarkResult> results;
+    try {
+        JsonParser json(text);
+        json.parseObject([&](const std::string& section) {
+            if (section == "metadata") {
+                json.parseObject([&](const std::string& key) {
+                    metadata[key] = json.parseString();
+                });
+            } else if (section == "benchmarks") {
+                json.parseArray([&] {
+                    BenchmarkResult r;
+                    double samples = 0.0, outliers = 0.0;
+                    const std::map<std::string, double*> numbers = {
+                        {"samples", &samples}, {"outliers", &outliers},
+                        {"median_ms", &r.median_ms}, {"mad_ms", &r.mad_ms},
+                        {"mean_ms", &r.mean_ms}, {"stddev_ms", &r.stddev_ms},
+                        {"min_ms", &r.min_ms}, {"max_ms", &r.max_ms},
+                        {"ci_low_ms", &r.ci_low_ms}, {"ci_high_ms", &r.ci_high_ms},
+                        {"bytes", &r.bytes}, {"flops", &r.flops},
+                    };
+                    json.parseObject([&](const std::string& key) {
+                        auto number = numbers.find(key);
+                        if (key == "name") {
+                            r.name = json.parseString();
+                        } else if (key == "timing") {
+                            r.device_timing = json.parseString() == "device";
+                        } else if (number != numbers.end() && !json.isString()) {
+                            *number->second = json.parseNumber();
+                        } else {
+                            json.skipValue();  // Derived (gb_per_s, ...) or unknown
+                        }
+                    });
+                    r.samples = static_cast<size_t>(samples);
+                    r.outliers = static_cast<size_t>(outliers);
+                    results.push_back(r);
+                });
+            } else {
+                json.skipValue();
+            }
+        });
+    } catch (const std::exception&) {
+        return false;  // Malformed JSON or number
+    }
+    
+    metadata_ = std::move(metadata);
+    results_ = std::move(results);
+    return true;
+}
+
+} // namespace ocl
@@ -48,5 +48,35 @@ void CommandQueue::flush() {
     checkError(err, "flushing command queue");
 }
 
-} // namespace ocl
+namespace {
+
+std::vector<cl_event> eventHandles(const std::vector<Event>& events) {
+    std::vector<cl_event> handles;
+    handles.reserve(events.size());
+    for (const auto& event : events) {
+        if (event.isValid()) {
+            handles.push_back(event.get());
+        }
+    }
+    return handles;
+}
+
+} // namespace
 
+Event CommandQueue::enqueueMarker(const std::vector<Event>& wait_for) {
+    std::vector<cl_event> handles = eventHandles(wait_for);
+    cl_event event;
+    cl_int err = clEnqueueMarkerWithWaitList(queue_, static_cast<cl_uint>(handles.size()),
+                                             handles.empty() ? nullptr : handles.data(), &event);
+    checkError(err, "enqueueing marker");
+    return Event(event);
+}
+
+void CommandQueue::enqueueBarrier(const std::vector<Event>& wait_for) {
+    std::vector<cl_event> handles = eventHandles(wait_for);
+    cl_int err = clEnqueueBarrierWithWaitList(queue_, static_cast<cl_uint>(handles.size()),
+                                              handles.empty() ? nullptr : handles.data(), nullptr);
+    checkError(err, "enqueueing barrier");
+}
+
+} // namespace ocl
@@ -36,6 +36,8 @@ Context::Context(const std::vector<Device>& devices) {
     checkError(err, "creating context");
 }
 
+Context::Context(cl_context context) : context_(context) {}
+
 Context::~Context() {
     if (context_) {
         clReleaseContext(context_);
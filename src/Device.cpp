@@ -1,5 +1,11 @@
 #include <ocl/Device.hpp>
 #include <ocl/Platform.hpp>
+#include <sstream>
+
+// Same value as CL_DEVICE_IL_VERSION (OpenCL 2.1); defined in cl_ext.h
+#ifndef CL_DEVICE_IL_VERSION_KHR
+#define CL_DEVICE_IL_VERSION_KHR 0x105B
+#endif
 
 namespace ocl {
 
@@ -55,6 +61,20 @@ std::string Device::getVersion() const {
     return ocl::getInfoString(id_, CL_DEVICE_VERSION);
 }
 
+std::string Device::getDriverVersion() const {
+    return ocl::getInfoString(id_, CL_DRIVER_VERSION);
+}
+
+cl_uint Device::getVersionNumber() const {
+    // Version string format: "OpenCL <major>.<minor> <vendor-specific>"
+    std::istringstream version(getVersion());
+    std::string prefix;
+    cl_uint major = 0, minor = 0;
+    char dot = 0;
+    version >> prefix >> major >> dot >> minor;
+    return major * 100 + minor * 10;
+}
+
 cl_device_type Device::getType() const {
     return getInfo<cl_device_type>(CL_DEVICE_TYPE);
 }
@@ -67,14 +87,70 @@ cl_ulong Device::getLocalMemSize() const {
     return getInfo<cl_ulong>(CL_DEVICE_LOCAL_MEM_SIZE);
 }
 
+cl_ulong Device::getMaxMemAllocSize() const {
+    return getInfo<cl_ulong>(CL_DEVICE_MAX_MEM_ALLOC_SIZE);
+}
+
 cl_uint Device::getMaxComputeUnits() const {
     return getInfo<cl_uint>(CL_DEVICE_MAX_COMPUTE_UNITS);
 }
 
+cl_uint Device::getMaxClockFrequency() const {
+    return getInfo<cl_uint>(CL_DEVICE_MAX_CLOCK_FREQUENCY);
+}
+
 cl_uint Device::getMaxWorkGroupSize() const {
     return getInfo<cl_uint>(CL_DEVICE_MAX_WORK_GROUP_SIZE);
 }
 
+cl_uint Device::getMemBaseAddrAlign() const {
+    return getInfo<cl_uint>(CL_DEVICE_MEM_BASE_ADDR_ALIGN);
+}
+
+cl_uint Device::getPreferredVectorWidthChar() const {
+    return getInfo<cl_uint>(CL_DEVICE_PREFERRED_VECTOR_WIDTH_CHAR);
+}
+
+cl_uint Device::getPreferredVectorWidthInt() const {
+    return getInfo<cl_uint>(CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT);
+}
+
+cl_uint Device::getPreferredVectorWidthFloat() const {
+    return getInfo<cl_uint>(CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT);
+}
+
+cl_uint Device::getPreferredVectorWidthDouble() const {
+    return getInfo<cl_uint>(CL_DEVICE_PREFERRED_VECTOR_WIDTH_DOUBLE);
+}
+
+std::string Device::getExtensions() const {
+    return ocl::getInfoString(id_, CL_DEVICE_EXTENSIONS);
+}
+
+std::string Device::getILVersion() const {
+    // Core in OpenCL 2.1 (optional again in 3.0), cl_khr_il_program before
+    if (getVersionNumber() < 210 && !hasExtension("cl_khr_il_program")) {
+        return "";
+    }
+    return ocl::getInfoString(id_, CL_DEVICE_IL_VERSION_KHR);
+}
+
+bool Device::hasExtension(const std::string& name) const {
+    // Extensions are a space-separated list; match whole names only
+    std::istringstream extensions(getExtensions());
+    std::string ext;
+    while (extensions >> ext) {
+        if (ext == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Platform Device::getPlatform() const {
+    return Platform(getInfo<cl_platform_id>(CL_DEVICE_PLATFORM));
+}
+
 std::string Device::getInfoString(cl_device_info param) const {
     return ocl::getInfoString(id_, param);
 }
@@ -91,5 +167,30 @@ bool Device::isAccelerator() const {
     return (getType() & CL_DEVICE_TYPE_ACCELERATOR) != 0;
 }
 
-} // namespace ocl
+bool Device::supportsIntegerDotProduct() const {
+    return hasExtension("cl_khr_integer_dot_product");
+}
+
+bool Device::supportsSubgroups() const {
+    // Sub-group built-ins need OpenCL C 2.0 (-cl-std=CL2.0)
+    return getVersionNumber() >= 200 && hasExtension("cl_khr_subgroups");
+}
+
+bool Device::supportsFP64() const {
+    // Optional core feature since 1.2; older devices only report the extension
+    return hasExtension("cl_khr_fp64") || getPreferredVectorWidthDouble() > 0;
+}
 
+bool Device::supportsIL() const {
+    if (hasExtension("cl_khr_il_program")) {
+        return true;
+    }
+#if CL_TARGET_OPENCL_VERSION >= 210
+    // clCreateProgramWithIL is only linked in when targeting 2.1+
+    return getVersionNumber() >= 210 && getILVersion().find("SPIR-V") != std::string::npos;
+#else
+    return false;
+#endif
+}
+
+} // namespace ocl
@@ -0,0 +1,156 @@
+#include <ocl/ElementWise.hpp>
+#include <ocl/Context.hpp>
+#include <ocl/CommandQueue.hpp>
+#include <ocl/NDRange.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+
+namespace ocl {
+
+namespace {
+
+cl_uint preferredWidth(const Device& device, const std::string& type) {
+    if (type == "float") return device.getPreferredVectorWidthFloat();
+    if (type == "double") return device.getPreferredVectorWidthDouble();
+    if (type == "int" || type == "uint") return device.getPreferredVectorWidthInt();
+    if (type == "char" || type == "uchar") return device.getPreferredVectorWidthChar();
+    return 1;
+}
+
+bool isValidWidth(cl_uint width) {
+    return width == 1 || width == 2 || width == 4 || width == 8 || width == 16;
+}
+
+// True if a buffer starts on a multiple of `alignment` bytes (sub-buffer
+// offsets and CL_MEM_USE_HOST_PTR allocations can break this)
+bool isBufferAligned(cl_mem mem, size_t alignment) {
+    size_t offset = 0;
+    cl_int err = clGetMemObjectInfo(mem, CL_MEM_OFFSET, sizeof(size_t), &offset, nullptr);
+    checkError(err, "getting buffer offset");
+    if (offset % alignment != 0) {
+        return false;
+    }
+    
+    void* host_ptr = nullptr;
+    err = clGetMemObjectInfo(mem, CL_MEM_HOST_PTR, sizeof(void*), &host_ptr, nullptr);
+    checkError(err, "getting buffer host pointer");
+    return reinterpret_cast<uintptr_t>(host_ptr) % alignment == 0;
+}
+
+} // namespace
+
+ElementWise::ElementWise(const Context& context, const Device& device, const std::string& expression,
+                         const std::string& type, cl_uint vector_width)
+    : type_(type)
+    , vector_width_(vector_width > 0 ? vector_width : preferredWidth(device, type))
+    , base_align_bytes_(device.getMemBaseAddrAlign() / 8)
+    , local_size_(0) {
+    
+    if (vector_width_ == 0) {
+        throw std::invalid_argument("Device does not support element type: " + type);
+    }
+    if (!isValidWidth(vector_width_)) {
+        throw std::invalid_argument("Vector width must be 1, 2, 4, 8 or 16");
+    }
+    
+    program_ = Program(context, generateSource(expression, type, vector_width_));
+    program_.buildOptimized(device);
+    aligned_ = Kernel(program_, "elementwise_aligned");
+    unaligned_ = Kernel(program_, "elementwise_unaligned");
+    
+    // Fixed local size: preferred multiple scaled up to at most 256
+    size_t max_size = aligned_.getWorkGroupSize(device);
+    local_size_ = std::max(size_t(1), aligned_.getPreferredWorkGroupSizeMultiple(device));
+    while (local_size_ * 2 <= max_size && local_size_ * 2 <= 256) {
+        local_size_ *= 2;
+    }
+}
+
+std::string ElementWise::generateSource(const std::string& expression, const std::string& type, cl_uint vector_width) {
+    if (!isValidWidth(vector_width)) {
+        throw std::invalid_argument("Vector width must be 1, 2, 4, 8 or 16");
+    }
+    
+    const std::string w = std::to_string(vector_width);
+    const std::string vec = vector_width == 1 ? type : type + w;
+    const std::string load = vector_width == 1 ? "" : "vload" + w;
+    const std::string store = vector_width == 1 ? "" : "vstore" + w;
+    
+    std::ostringstream src;
+    if (type == "double") {
+        src << "#pragma OPENCL EXTENSION cl_khr_fp64 : enable\n";
+    }
+    src << "#define T " << type << "\n"
+        << "#define TN " << vec << "\n"
+        << "#define W " << vector_width << "\n"
+        << "#define EXPR (" << expression << ")\n\n";
+    
+    // Work-items [0, vec_count) process one vector each; the next
+    // (count - vec_count * W) work-items process one leftover scalar each.
+    const char* tail =
+        "    } else {\n"
+        "        const int j = vec_count * W + (i - vec_count);\n"
+        "        if (j < count) {\n"
+        "            T a = a_[j];\n"
+        "            T b = b_[j];\n"
+        "            out_[j] = EXPR;\n"
+        "        }\n"
+        "    }\n"
+        "}\n\n";
+    
+    const char* signature =
+        "(__global const T* a_, __global const T* b_, __global T* out_,\n"
+        "                                  const int vec_count, const int count) {\n"
+        "    const int i = get_global_id(0);\n"
+        "    if (i < vec_count) {\n";
+    
+    // Aligned: whole-vector loads through vector pointers
+    src << "__kernel void elementwise_aligned" << signature
+        << "        TN a = ((__global const TN*)a_)[i];\n"
+        << "        TN b = ((__global const TN*)b_)[i];\n"
+        << "        ((__global TN*)out_)[i] = EXPR;\n"
+        << tail;
+    
+    // Unaligned: vloadn/vstoren only need element alignment
+    src << "__kernel void elementwise_unaligned" << signature;
+    if (vector_width == 1) {
+        src << "        T a = a_[i];\n"
+            << "        T b = b_[i];\n"
+            << "        out_[i] = EXPR;\n";
+    } else {
+        src << "        TN a = " << load << "(i, a_);\n"
+            << "        TN b = " << load << "(i, b_);\n"
+            << "        " << store << "(EXPR, i, out_);\n";
+    }
+    src << tail;
+    
+    return src.str();
+}
+
+bool ElementWise::isAligned(cl_mem a, cl_mem b, cl_mem out, size_t element_size) const {
+    const size_t vector_bytes = element_size * vector_width_;
+    
+    // Buffer base addresses are only guaranteed to this alignment
+    if (base_align_bytes_ < vector_bytes) {
+        return false;
+    }
+    return isBufferAligned(a, vector_bytes) &&
+           isBufferAligned(b, vector_bytes) &&
+           isBufferAligned(out, vector_bytes);
+}
+
+void ElementWise::executeImpl(const CommandQueue& queue, cl_mem a, cl_mem b, cl_mem out, size_t count, size_t element_size) {
+    const size_t vec_count = count / vector_width_;
+    const size_t tail = count - vec_count * vector_width_;
+    const size_t work_items = vec_count + tail;
+    if (work_items == 0) {
+        return;
+    }
+    
+    Kernel& kernel = isAligned(a, b, out, element_size) ? aligned_ : unaligned_;
+    kernel.setArgs(a, b, out, static_cast<int>(vec_count), static_cast<int>(count));
+    kernel.execute(queue, NDRange::getPaddedGlobalSize(work_items, local_size_), local_size_);
+}
+
+} // namespace ocl
@@ -0,0 +1,83 @@
+#include <ocl/Embedded.hpp>
+#include <algorithm>
+#include <mutex>
+
+// Defined in the file generated by ocl_embed_kernels() for the ocl target
+void ocl_register_bundled_kernels();
+
+namespace ocl {
+
+namespace {
+
+struct EmbeddedTable {
+    std::mutex mutex;
+    std::vector<const EmbeddedFile*> files;
+};
+
+EmbeddedTable& table() {
+    static EmbeddedTable instance;
+    return instance;
+}
+
+// The library's own kernels are registered on first lookup, so the
+// generated object is always linked in. They go to the front of the table
+// so application tables registered earlier still take precedence.
+void registerBundled() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        auto& t = table();
+        size_t before;
+        {
+            std::lock_guard<std::mutex> lock(t.mutex);
+            before = t.files.size();
+        }
+        ocl_register_bundled_kernels();
+        std::lock_guard<std::mutex> lock(t.mutex);
+        std::rotate(t.files.begin(), t.files.begin() + before, t.files.end());
+    });
+}
+
+} // namespace
+
+void registerEmbeddedFiles(const EmbeddedFile* files, size_t count) {
+    auto& t = table();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    for (size_t i = 0; i < count; ++i) {
+        t.files.push_back(&files[i]);
+    }
+}
+
+const EmbeddedFile* findEmbedded(const std::string& name, EmbeddedFile::Kind kind, const std::string& device) {
+    registerBundled();
+    
+    auto& t = table();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    
+    // Later registrations override earlier ones (applications can replace
+    // bundled kernels)
+    for (auto it = t.files.rbegin(); it != t.files.rend(); ++it) {
+        const EmbeddedFile* file = *it;
+        if (file->kind == kind && name == file->name &&
+            (kind != EmbeddedFile::Binary || device == file->device)) {
+            return file;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::string> listEmbedded() {
+    registerBundled();
+    
+    auto& t = table();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    
+    std::vector<std::string> names;
+    for (const auto* file : t.files) {
+        if (file->kind == EmbeddedFile::Source) {
+            names.push_back(file->name);
+        }
+    }
+    return names;
+}
+
+} // namespace ocl
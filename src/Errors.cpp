@@ -1,6 +1,5 @@
 #include <ocl/Errors.hpp>
 #include <fstream>
-#include <sstream>
 
 namespace ocl {
 
@@ -65,16 +64,42 @@ const char* errorCodeToString(cl_int error) {
 }
 
 std::string readFile(const std::string& filepath) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
+    std::string contents;
+    if (!detail::tryReadFile(filepath, contents)) {
         throw std::runtime_error("Failed to open file: " + filepath);
     }
+    return contents;
+}
+
+namespace detail {
+
+bool tryReadFile(const std::string& filepath, std::string& contents) {
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
     
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
+    // Size the string once and read straight into it
+    contents.assign(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0, std::ios::beg);
+    file.read(&contents[0], contents.size());
+    if (!file.good() && !contents.empty()) {
+        throw std::runtime_error("Failed to read file: " + filepath);
+    }
+    return true;
 }
 
+uint64_t fnv1a(const std::string& data) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace detail
+
 std::string getInfoString(cl_platform_id platform, cl_platform_info param) {
     size_t size;
     cl_int err = clGetPlatformInfo(platform, param, 0, nullptr, &size);
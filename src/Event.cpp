@@ -1,4 +1,6 @@
 #include <ocl/Event.hpp>
+#include <ocl/Context.hpp>
+#include <ocl/Reclaimer.hpp>
 
 namespace ocl {
 
@@ -8,7 +10,7 @@ Event::Event(cl_event event) : event_(event) {}
 
 Event::~Event() {
     if (event_) {
-        clReleaseEvent(event_);
+        detail::releaseEvent(event_);
     }
 }
 
@@ -19,7 +21,7 @@ Event::Event(Event&& other) noexcept : event_(other.event_) {
 Event& Event::operator=(Event&& other) noexcept {
     if (this != &other) {
         if (event_) {
-            clReleaseEvent(event_);
+            detail::releaseEvent(event_);
         }
         event_ = other.event_;
         other.event_ = nullptr;
@@ -27,6 +29,30 @@ Event& Event::operator=(Event&& other) noexcept {
     return *this;
 }
 
+Event Event::createUser(const Context& context) {
+    cl_int err;
+    cl_event event = clCreateUserEvent(context.get(), &err);
+    checkError(err, "creating user event");
+    return Event(event);
+}
+
+void Event::setUserStatus(cl_int status) {
+    if (!event_) {
+        throw std::runtime_error("Cannot set status of invalid event");
+    }
+    
+    cl_int err = clSetUserEventStatus(event_, status);
+    checkError(err, "setting user event status");
+}
+
+Event Event::retain() const {
+    if (event_) {
+        cl_int err = clRetainEvent(event_);
+        checkError(err, "retaining event");
+    }
+    return Event(event_);
+}
+
 void Event::wait() {
     if (!event_) {
         throw std::runtime_error("Cannot wait on invalid event");
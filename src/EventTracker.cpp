@@ -0,0 +1,261 @@
+#include <ocl/EventTracker.hpp>
+#include <ocl/Event.hpp>
+#include <ocl/Reclaimer.hpp>
+
+namespace ocl {
+
+namespace {
+
+// Cleared when the tracker is destroyed at exit: late callbacks and
+// handles destroyed afterwards leave the (freed) pool alone
+std::atomic<bool> g_tracker_alive{false};
+
+} // namespace
+
+TrackedEvent::~TrackedEvent() {
+    if (slot_ && g_tracker_alive.load(std::memory_order_acquire)) {
+        EventTracker::instance().dropRef(index_);
+    }
+}
+
+TrackedEvent& TrackedEvent::operator=(TrackedEvent&& other) noexcept {
+    if (this != &other) {
+        if (slot_ && g_tracker_alive.load(std::memory_order_acquire)) {
+            EventTracker::instance().dropRef(index_);
+        }
+        slot_ = other.slot_;
+        index_ = other.index_;
+        other.slot_ = nullptr;
+    }
+    return *this;
+}
+
+void TrackedEvent::wait() {
+    if (!slot_) {
+        throw std::runtime_error("Cannot wait on invalid tracked event");
+    }
+    if (isFinished()) {
+        return;
+    }
+    
+    cl_int err = clWaitForEvents(1, &slot_->event);
+    if (err == CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST) {
+        cl_int status = err;
+        clGetEventInfo(slot_->event, CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(cl_int), &status, nullptr);
+        slot_->status.store(status < 0 ? status : err, std::memory_order_release);
+    }
+    checkError(err, "waiting for tracked event");
+    slot_->status.store(CL_COMPLETE, std::memory_order_release);
+}
+
+EventTracker& EventTracker::instance() {
+    static EventTracker tracker;
+    return tracker;
+}
+
+EventTracker::EventTracker()
+    : mode_(TrackingMode::Callback), poll_interval_(100),
+      chunks_(new std::atomic<detail::EventSlot*>[kMaxChunks]), stopping_(false) {
+    for (uint32_t i = 0; i < kMaxChunks; ++i) {
+        chunks_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    g_tracker_alive.store(true, std::memory_order_release);
+}
+
+EventTracker::~EventTracker() {
+    g_tracker_alive.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (poller_.joinable()) {
+        poller_.join();
+    }
+    // Events still referenced are left to process teardown
+    for (uint32_t i = 0; i < kMaxChunks; ++i) {
+        delete[] chunks_[i].load(std::memory_order_relaxed);
+    }
+}
+
+void EventTracker::setMode(TrackingMode mode, std::chrono::microseconds poll_interval) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    poll_interval_ = poll_interval;
+    // Started before the switch: every event tracked in Polling mode has a poller
+    if (mode == TrackingMode::Polling && !poller_.joinable()) {
+        poller_ = std::thread([this]() { poll(); });
+    }
+    mode_.store(mode, std::memory_order_release);
+}
+
+TrackedEvent EventTracker::track(const Event& event) {
+    if (!event.isValid()) {
+        throw std::runtime_error("Cannot track invalid event");
+    }
+    checkError(clRetainEvent(event.get()), "retaining tracked event");
+    return trackHandle(event.get());
+}
+
+TrackedEvent EventTracker::track(Event&& event) {
+    if (!event.isValid()) {
+        throw std::runtime_error("Cannot track invalid event");
+    }
+    cl_event handle = event.get();
+    *event.ptr() = nullptr;  // The slot owns the reference now
+    return trackHandle(handle);
+}
+
+TrackedEvent EventTracker::trackHandle(cl_event event) {
+    const TrackingMode mode = mode_.load(std::memory_order_acquire);
+    uint32_t index;
+    try {
+        index = allocateSlot();
+    } catch (...) {
+        detail::releaseEvent(event);
+        throw;
+    }
+    detail::EventSlot& s = slot(index);
+    s.event = event;
+    s.status.store(CL_QUEUED, std::memory_order_relaxed);
+    s.refs.store(2, std::memory_order_relaxed);  // Handle + callback/poller
+    if (mode == TrackingMode::Polling) {
+        watched_.fetch_add(1, std::memory_order_relaxed);
+    }
+    s.watched.store(mode == TrackingMode::Polling, std::memory_order_release);  // Publishes the slot to the poller
+    active_.fetch_add(1, std::memory_order_relaxed);
+    
+    if (mode == TrackingMode::Callback) {
+        // Index travels as the user data; the slot is not reused before the
+        // callback drops its reference
+        cl_int err = clSetEventCallback(event, CL_COMPLETE, onComplete,
+                                        reinterpret_cast<void*>(static_cast<uintptr_t>(index)));
+        if (err != CL_SUCCESS) {
+            dropRef(index);
+            dropRef(index);
+            checkError(err, "setting tracker callback");
+        }
+    } else {
+        // Pairs with the idle check in poll(): either the poller sees the
+        // slot or this sees it idle and wakes it under the mutex
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (idle_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wake_.notify_one();
+        }
+    }
+    return TrackedEvent(&s, index);
+}
+
+void CL_CALLBACK EventTracker::onComplete(cl_event, cl_int status, void* user_data) {
+    if (!g_tracker_alive.load(std::memory_order_acquire)) {
+        return;
+    }
+    EventTracker& tracker = instance();
+    const uint32_t index = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(user_data));
+    tracker.slot(index).status.store(status, std::memory_order_release);
+    tracker.dropRef(index);
+}
+
+uint32_t EventTracker::allocateSlot() {
+    for (;;) {
+        // Pop from the free list (tagged head against ABA)
+        uint64_t head = free_head_.load(std::memory_order_acquire);
+        while (static_cast<uint32_t>(head) != 0) {
+            const uint32_t index = static_cast<uint32_t>(head) - 1;
+            const uint32_t next = slot(index).next_free.load(std::memory_order_relaxed);
+            const uint64_t replacement = ((head >> 32) + 1) << 32 | next;
+            if (free_head_.compare_exchange_weak(head, replacement, std::memory_order_acq_rel)) {
+                return index;
+            }
+        }
+        
+        // Empty: grow by a chunk (unless another thread just did), keep its
+        // first slot and free the rest
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (static_cast<uint32_t>(free_head_.load(std::memory_order_acquire)) != 0) {
+            continue;
+        }
+        const uint32_t base = pool_size_.load(std::memory_order_relaxed);
+        if (base / kChunkSize >= kMaxChunks) {
+            throw std::runtime_error("EventTracker: too many events in flight");
+        }
+        chunks_[base / kChunkSize].store(new detail::EventSlot[kChunkSize], std::memory_order_release);
+        pool_size_.store(base + kChunkSize, std::memory_order_release);
+        for (uint32_t i = kChunkSize - 1; i > 0; --i) {
+            pushFree(base + i);
+        }
+        return base;
+    }
+}
+
+void EventTracker::pushFree(uint32_t index) {
+    uint64_t head = free_head_.load(std::memory_order_relaxed);
+    for (;;) {
+        slot(index).next_free.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        const uint64_t replacement = ((head >> 32) + 1) << 32 | (index + 1);
+        if (free_head_.compare_exchange_weak(head, replacement, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+}
+
+void EventTracker::dropRef(uint32_t index) {
+    detail::EventSlot& s = slot(index);
+    if (s.refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    cl_event event = s.event;
+    s.event = nullptr;
+    active_.fetch_sub(1, std::memory_order_relaxed);
+    detail::releaseEvent(event);
+    pushFree(index);
+}
+
+void EventTracker::poll() {
+    for (;;) {
+        // One pass over the pool: query pending events, and drop the
+        // poller's reference once an event finished or its handle is gone
+        bool pending = false;
+        const uint32_t size = pool_size_.load(std::memory_order_acquire);
+        for (uint32_t index = 0; index < size; ++index) {
+            detail::EventSlot& s = slot(index);
+            if (!s.watched.load(std::memory_order_acquire)) {
+                continue;
+            }
+            cl_int status = s.status.load(std::memory_order_acquire);
+            const bool abandoned = s.refs.load(std::memory_order_acquire) == 1;
+            if (status > CL_COMPLETE && !abandoned) {
+                cl_int err = clGetEventInfo(s.event, CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(cl_int), &status, nullptr);
+                if (err != CL_SUCCESS) {
+                    status = err;
+                }
+                if (status <= CL_COMPLETE) {
+                    s.status.store(status, std::memory_order_release);
+                }
+            }
+            if (status <= CL_COMPLETE || abandoned) {
+                s.watched.store(false, std::memory_order_relaxed);
+                watched_.fetch_sub(1, std::memory_order_relaxed);
+                dropRef(index);
+            } else {
+                pending = true;
+            }
+        }
+        
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        if (pending) {
+            wake_.wait_for(lock, poll_interval_);
+        } else {
+            // Nothing to poll: sleep until track() registers an event
+            idle_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            wake_.wait(lock, [this]() { return stopping_ || watched_.load(std::memory_order_relaxed) > 0; });
+            idle_.store(false, std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace ocl
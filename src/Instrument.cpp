@@ -0,0 +1,242 @@
+#include <ocl/Instrument.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace ocl {
+
+namespace {
+
+struct SiteTotals {
+    size_t count = 0;
+    uint64_t total = 0;
+    uint64_t min = std::numeric_limits<uint64_t>::max();
+    uint64_t max = 0;
+};
+
+struct InstrumentState {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<detail::ThreadRing>> rings;
+    std::vector<detail::ThreadRing*> free_rings;  // Of exited threads
+    std::unordered_map<const ScopeSite*, SiteTotals> totals;
+    uint64_t dropped = 0;
+    
+    // Calibration reference, taken when the first thread registers
+    uint64_t ref_ticks = 0;
+    std::chrono::steady_clock::time_point ref_time;
+    
+    // Fold new records of every ring (or one) into totals (mutex held)
+    void collect();
+    void collectRing(detail::ThreadRing& ring);
+};
+
+InstrumentState& state() {
+    static InstrumentState instance;
+    return instance;
+}
+
+void InstrumentState::collect() {
+    for (auto& ring : rings) {
+        collectRing(*ring);
+    }
+}
+
+void InstrumentState::collectRing(detail::ThreadRing& ring) {
+    const uint64_t size = detail::ThreadRing::kSize;
+    const uint64_t head = ring.head.load(std::memory_order_acquire);
+    uint64_t begin = ring.consumed;
+    if (head - begin > size) {
+        dropped += head - begin - size;
+        begin = head - size;
+    }
+    
+    struct Copy { const ScopeSite* site; uint64_t start; uint64_t end; };
+    std::vector<Copy> copies;
+    copies.reserve(static_cast<size_t>(head - begin));
+    for (uint64_t i = begin; i < head; ++i) {
+        const detail::ScopeRecord& record = ring.records[i & (size - 1)];
+        copies.push_back({record.site.load(std::memory_order_relaxed),
+                          record.start.load(std::memory_order_relaxed),
+                          record.end.load(std::memory_order_relaxed)});
+    }
+    
+    // Records the owner may have overwritten while they were copied
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t after = ring.head.load(std::memory_order_relaxed);
+    const uint64_t first_valid = after >= size ? after - size + 1 : 0;
+    
+    for (uint64_t i = begin; i < head; ++i) {
+        if (i < first_valid) {
+            ++dropped;
+            continue;
+        }
+        const Copy& copy = copies[static_cast<size_t>(i - begin)];
+        const uint64_t ticks = copy.end - copy.start;
+        SiteTotals& site = totals[copy.site];
+        ++site.count;
+        site.total += ticks;
+        site.min = std::min(site.min, ticks);
+        site.max = std::max(site.max, ticks);
+    }
+    ring.consumed = head;
+}
+
+// Set once a thread's RingOwner is destroyed; scopes in later thread-exit
+// destructors get a ring of their own that is not handed back
+thread_local bool t_ring_released = false;
+
+// Hands the thread's ring back for reuse when the thread exits
+struct RingOwner {
+    detail::ThreadRing* ring = nullptr;
+    detail::ThreadRing** slot = nullptr;
+    
+    ~RingOwner() {
+        if (!ring) {
+            return;
+        }
+        *slot = nullptr;
+        t_ring_released = true;
+        InstrumentState& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.free_rings.push_back(ring);
+    }
+};
+
+} // namespace
+
+namespace detail {
+
+ThreadRing* registerThreadRing(ThreadRing** slot) {
+    InstrumentState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.rings.empty()) {
+        s.ref_ticks = readTicks();
+        s.ref_time = std::chrono::steady_clock::now();
+    }
+    
+    ThreadRing* ring;
+    if (!s.free_rings.empty()) {
+        // Fold the previous thread's records in before they are overwritten
+        ring = s.free_rings.back();
+        s.free_rings.pop_back();
+        s.collectRing(*ring);
+    } else {
+        s.rings.emplace_back(new ThreadRing());
+        ring = s.rings.back().get();
+    }
+    
+    if (!t_ring_released) {
+        static thread_local RingOwner owner;
+        owner.ring = ring;
+        owner.slot = slot;
+    }
+    return ring;
+}
+
+} // namespace detail
+
+double Instrument::getTicksPerSecond() {
+    InstrumentState& s = state();
+    uint64_t ref_ticks;
+    std::chrono::steady_clock::time_point ref_time;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (s.rings.empty()) {
+            s.ref_ticks = detail::readTicks();
+            s.ref_time = std::chrono::steady_clock::now();
+        }
+        ref_ticks = s.ref_ticks;
+        ref_time = s.ref_time;
+    }
+    
+    // Needs a few milliseconds since the reference for a stable ratio
+    const auto min_span = std::chrono::milliseconds(20);
+    auto elapsed = std::chrono::steady_clock::now() - ref_time;
+    if (elapsed < min_span) {
+        std::this_thread::sleep_for(min_span - elapsed);
+    }
+    const uint64_t ticks = detail::readTicks();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - ref_time).count();
+    return (ticks - ref_ticks) / seconds;
+}
+
+std::vector<ScopeStats> Instrument::getStats() {
+    const double ms_per_tick = 1000.0 / getTicksPerSecond();
+    
+    InstrumentState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.collect();
+    
+    std::vector<ScopeStats> stats;
+    stats.reserve(s.totals.size());
+    for (const auto& entry : s.totals) {
+        ScopeStats st;
+        st.name = entry.first->name;
+        st.file = entry.first->file;
+        st.line = entry.first->line;
+        st.count = entry.second.count;
+        st.total_ms = entry.second.total * ms_per_tick;
+        st.min_ms = entry.second.min * ms_per_tick;
+        st.max_ms = entry.second.max * ms_per_tick;
+        stats.push_back(st);
+    }
+    std::sort(stats.begin(), stats.end(), [](const ScopeStats& a, const ScopeStats& b) {
+        return a.total_ms > b.total_ms;
+    });
+    return stats;
+}
+
+uint64_t Instrument::getDroppedRecords() {
+    InstrumentState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.collect();
+    return s.dropped;
+}
+
+void Instrument::printResults() {
+    std::vector<ScopeStats> stats = getStats();
+    
+    std::cout << "\n";
+    std::cout << "═══════════════════════════════════════════════════════════════════════\n";
+    std::cout << "  Instrumentation Scopes" << (isEnabled() ? "" : " (OCL_ENABLE_INSTRUMENTATION is off)") << "\n";
+    std::cout << "═══════════════════════════════════════════════════════════════════════\n";
+    std::cout << std::left << std::setw(30) << "Scope"
+              << std::right << std::setw(10) << "Count"
+              << std::setw(12) << "Total (ms)"
+              << std::setw(10) << "Avg (us)"
+              << std::setw(10) << "Max (us)" << "\n";
+    std::cout << "───────────────────────────────────────────────────────────────────────\n";
+    for (const auto& st : stats) {
+        std::cout << std::left << std::setw(30) << st.name
+                  << std::right << std::setw(10) << st.count
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(12) << st.total_ms
+                  << std::setprecision(2)
+                  << std::setw(10) << st.getAverageMs() * 1000.0
+                  << std::setw(10) << st.max_ms * 1000.0 << "\n";
+    }
+    
+    const uint64_t dropped = getDroppedRecords();
+    if (dropped > 0) {
+        std::cout << dropped << " records overwritten before collection (raise OCL_INSTRUMENT_RING_SIZE)\n";
+    }
+    std::cout << "═══════════════════════════════════════════════════════════════════════\n\n";
+}
+
+void Instrument::reset() {
+    InstrumentState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    for (auto& ring : s.rings) {
+        ring->consumed = ring->head.load(std::memory_order_acquire);
+    }
+    s.totals.clear();
+    s.dropped = 0;
+}
+
+} // namespace ocl
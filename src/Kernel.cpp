@@ -2,46 +2,80 @@
 #include <ocl/Program.hpp>
 #include <ocl/CommandQueue.hpp>
 #include <ocl/Device.hpp>
+#include <ocl/Metrics.hpp>
+#include <ocl/Reclaimer.hpp>
+#include <sstream>
+
+// Register spill bytes per work-item; defined in cl_ext.h (Intel drivers only)
+#ifndef CL_KERNEL_SPILL_MEM_SIZE_INTEL
+#define CL_KERNEL_SPILL_MEM_SIZE_INTEL 0x4109
+#endif
 
 namespace ocl {
 
-Kernel::Kernel() : kernel_(nullptr) {}
+std::string KernelInfo::toString() const {
+    std::ostringstream out;
+    out << name << ": wg<=" << work_group_size << " (x" << preferred_multiple << ")";
+    if (hasCompileWorkGroupSize()) {
+        out << ", reqd " << compile_work_group_size[0] << "x" << compile_work_group_size[1]
+            << "x" << compile_work_group_size[2];
+    }
+    out << ", local " << local_mem_size << " B, private " << private_mem_size << " B";
+    if (has_spill_info) {
+        out << ", spill " << spill_mem_size << " B";
+    }
+    return out.str();
+}
+
+Kernel::Kernel() : kernel_(nullptr), launches_(nullptr), timing_(nullptr) {}
 
-Kernel::Kernel(const Program& program, const std::string& name) {
+Kernel::Kernel(const Program& program, const std::string& name) : launches_(nullptr), timing_(nullptr) {
     cl_int err;
     kernel_ = clCreateKernel(program.get(), name.c_str(), &err);
     checkError(err, "creating kernel: " + name);
 }
 
+Kernel::Kernel(cl_kernel kernel) : kernel_(kernel), launches_(nullptr), timing_(nullptr) {}
+
 Kernel::~Kernel() {
     if (kernel_) {
-        clReleaseKernel(kernel_);
+        detail::releaseKernel(kernel_);
     }
 }
 
-Kernel::Kernel(Kernel&& other) noexcept : kernel_(other.kernel_) {
+Kernel::Kernel(Kernel&& other) noexcept : kernel_(other.kernel_), launches_(other.launches_), timing_(other.timing_) {
     other.kernel_ = nullptr;
+    other.launches_ = nullptr;
+    other.timing_ = nullptr;
 }
 
 Kernel& Kernel::operator=(Kernel&& other) noexcept {
     if (this != &other) {
         if (kernel_) {
-            clReleaseKernel(kernel_);
+            detail::releaseKernel(kernel_);
         }
         kernel_ = other.kernel_;
+        launches_ = other.launches_;
+        timing_ = other.timing_;
         other.kernel_ = nullptr;
+        other.launches_ = nullptr;
+        other.timing_ = nullptr;
     }
     return *this;
 }
 
 void Kernel::setArg(cl_uint index, cl_mem mem) {
     cl_int err = clSetKernelArg(kernel_, index, sizeof(cl_mem), &mem);
-    checkError(err, "setting kernel mem arg " + std::to_string(index));
+    if (err != CL_SUCCESS) {
+        throw Error(err, "setting kernel mem arg " + std::to_string(index));
+    }
 }
 
 void Kernel::setLocalArg(cl_uint index, size_t size_in_bytes) {
     cl_int err = clSetKernelArg(kernel_, index, size_in_bytes, nullptr);
-    checkError(err, "setting kernel local memory arg " + std::to_string(index));
+    if (err != CL_SUCCESS) {
+        throw Error(err, "setting kernel local memory arg " + std::to_string(index));
+    }
 }
 
 void Kernel::execute(const CommandQueue& queue, size_t global_work_size, size_t local_work_size) {
@@ -51,8 +85,12 @@ void Kernel::execute(const CommandQueue& queue, size_t global_work_size, size_t
     }
     
     const size_t* local = (local_work_size > 0) ? &local_work_size : nullptr;
-    cl_int err = clEnqueueNDRangeKernel(queue.get(), kernel_, 1, nullptr, &global_work_size, local, 0, nullptr, nullptr);
+    const uint32_t weight = sampleLaunch();
+    cl_event event = nullptr;
+    cl_int err = clEnqueueNDRangeKernel(queue.get(), kernel_, 1, nullptr, &global_work_size, local, 0, nullptr,
+                                        weight ? &event : nullptr);
     checkError(err, "executing kernel");
+    countLaunch(event, weight);
 }
 
 void Kernel::execute2D(const CommandQueue& queue, size_t global_width, size_t global_height,size_t local_width, size_t local_height) {
@@ -60,8 +98,12 @@ void Kernel::execute2D(const CommandQueue& queue, size_t global_width, size_t gl
     size_t local[2] = {local_width, local_height};
     const size_t* local_ptr = (local_width > 0 && local_height > 0) ? local : nullptr;
     
-    cl_int err = clEnqueueNDRangeKernel(queue.get(), kernel_, 2, nullptr, global, local_ptr, 0, nullptr, nullptr);
+    const uint32_t weight = sampleLaunch();
+    cl_event event = nullptr;
+    cl_int err = clEnqueueNDRangeKernel(queue.get(), kernel_, 2, nullptr, global, local_ptr, 0, nullptr,
+                                        weight ? &event : nullptr);
     checkError(err, "executing kernel 2D");
+    countLaunch(event, weight);
 }
 
 void Kernel::execute3D(const CommandQueue& queue, size_t global_x, size_t global_y, size_t global_z, size_t local_x, size_t local_y, size_t local_z) {
@@ -69,8 +111,33 @@ void Kernel::execute3D(const CommandQueue& queue, size_t global_x, size_t global
     size_t local[3] = {local_x, local_y, local_z};
     const size_t* local_ptr = (local_x > 0 && local_y > 0 && local_z > 0) ? local : nullptr;
     
-    cl_int err = clEnqueueNDRangeKernel(queue.get(), kernel_, 3, nullptr, global, local_ptr, 0, nullptr, nullptr);
+    const uint32_t weight = sampleLaunch();
+    cl_event event = nullptr;
+    cl_int err = clEnqueueNDRangeKernel(queue.get(), kernel_, 3, nullptr, global, local_ptr, 0, nullptr,
+                                        weight ? &event : nullptr);
     checkError(err, "executing kernel 3D");
+    countLaunch(event, weight);
+}
+
+uint32_t Kernel::sampleLaunch() {
+    if (!Metrics::instance().isKernelTiming()) {
+        return 0;
+    }
+    if (!timing_) {
+        timing_ = &detail::kernelTiming(detail::kernelName(kernel_));
+    }
+    return timing_->sampler.next();
+}
+
+void Kernel::countLaunch(cl_event event, uint32_t weight) {
+    if (!launches_) {
+        launches_ = &detail::kernelLaunchCounter(detail::kernelName(kernel_));
+    }
+    launches_->inc();
+    if (event) {
+        detail::observeKernelDuration(event, timing_->durations, weight);
+        clReleaseEvent(event);
+    }
 }
 
 size_t Kernel::getWorkGroupSize(const Device& device) const {
@@ -94,5 +161,54 @@ cl_ulong Kernel::getLocalMemSize(const Device& device) const {
     return size;
 }
 
+cl_ulong Kernel::getPrivateMemSize(const Device& device) const {
+    cl_ulong size;
+    cl_int err = clGetKernelWorkGroupInfo(kernel_, device.id(), CL_KERNEL_PRIVATE_MEM_SIZE, sizeof(cl_ulong), &size, nullptr);
+    checkError(err, "getting kernel private mem size");
+    return size;
+}
+
+KernelInfo Kernel::getInfo(const Device& device) const {
+    KernelInfo info;
+    info.name = getName();
+    info.work_group_size = getWorkGroupSize(device);
+    info.preferred_multiple = getPreferredWorkGroupSizeMultiple(device);
+    info.local_mem_size = getLocalMemSize(device);
+    info.private_mem_size = getPrivateMemSize(device);
+    
+    cl_int err = clGetKernelWorkGroupInfo(kernel_, device.id(), CL_KERNEL_COMPILE_WORK_GROUP_SIZE,
+                                          sizeof(info.compile_work_group_size), info.compile_work_group_size, nullptr);
+    checkError(err, "getting kernel compile work group size");
+    
+    // Vendor query: other drivers reject it with CL_INVALID_VALUE
+    info.has_spill_info = clGetKernelWorkGroupInfo(kernel_, device.id(), CL_KERNEL_SPILL_MEM_SIZE_INTEL,
+                                                   sizeof(cl_ulong), &info.spill_mem_size, nullptr) == CL_SUCCESS;
+    if (!info.has_spill_info) {
+        info.spill_mem_size = 0;
+    }
+    return info;
+}
+
+std::string Kernel::getName() const {
+    return detail::kernelName(kernel_);
+}
+
+namespace detail {
+
+std::string kernelName(cl_kernel kernel) {
+    size_t size = 0;
+    cl_int err = clGetKernelInfo(kernel, CL_KERNEL_FUNCTION_NAME, 0, nullptr, &size);
+    checkError(err, "getting kernel name");
+    std::string name(size, '\0');
+    err = clGetKernelInfo(kernel, CL_KERNEL_FUNCTION_NAME, size, &name[0], nullptr);
+    checkError(err, "getting kernel name");
+    while (!name.empty() && name.back() == '\0') {
+        name.pop_back();
+    }
+    return name;
+}
+
+} // namespace detail
+
 } // namespace ocl
 
@@ -0,0 +1,183 @@
+#include <ocl/KernelCache.hpp>
+#include <ocl/Device.hpp>
+#include <ocl/Embedded.hpp>
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+namespace ocl {
+
+namespace {
+
+std::string programKey(const Device& device, const std::string& source, const std::string& options) {
+    std::ostringstream key;
+    key << device.id() << '\n' << source << '\n' << options;
+    return key.str();
+}
+
+std::mutex& contextCachesMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::map<cl_context, std::unique_ptr<KernelCache>>& contextCaches() {
+    static std::map<cl_context, std::unique_ptr<KernelCache>> caches;
+    return caches;
+}
+
+// A second owning Context for the same handle
+Context retainContext(const Context& context) {
+    cl_int err = clRetainContext(context.get());
+    checkError(err, "retaining context");
+    return Context(context.get());
+}
+
+} // namespace
+
+KernelCache::KernelCache(const Context& context) : context_(retainContext(context)) {}
+
+KernelCache& KernelCache::forContext(const Context& context) {
+    std::lock_guard<std::mutex> lock(contextCachesMutex());
+    std::unique_ptr<KernelCache>& cache = contextCaches()[context.get()];
+    if (!cache) {
+        cache.reset(new KernelCache(context));
+    }
+    return *cache;
+}
+
+void KernelCache::release(const Context& context) {
+    std::unique_ptr<KernelCache> cache;
+    {
+        std::lock_guard<std::mutex> lock(contextCachesMutex());
+        auto it = contextCaches().find(context.get());
+        if (it == contextCaches().end()) {
+            return;
+        }
+        cache = std::move(it->second);
+        contextCaches().erase(it);
+    }
+    // Destroyed outside the lock
+}
+
+void KernelCache::addSource(const std::string& id, const std::string& source) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sources_[id] = source;
+}
+
+KernelSource KernelCache::loadSource(const std::string& id) const {
+    std::string text;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sources_.find(id);
+        if (it == sources_.end()) {
+            return loader_.loadFile(id);
+        }
+        text = it->second;
+    }
+    return loader_.load(id, text);
+}
+
+const Program& KernelCache::getProgram(const Device& device, const std::string& source, const std::string& options) {
+    const std::string key = programKey(device, source, options);
+    
+    // Single flight: the first caller builds, later ones wait on its future
+    std::promise<std::shared_ptr<Program>> promise;
+    std::shared_future<std::shared_ptr<Program>> future;
+    bool builder = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = programs_.find(key);
+        if (it != programs_.end()) {
+            future = it->second;
+        } else {
+            future = promise.get_future().share();
+            programs_.emplace(key, future);
+            builder = true;
+        }
+    }
+    
+    if (builder) {
+        try {
+            bool registered;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                registered = sources_.count(source) > 0;
+            }
+            std::shared_ptr<Program> program;
+            if (!registered && findEmbedded(source)) {
+                program = std::make_shared<Program>(Program::buildEmbedded(context_, device, source, options));
+            } else {
+                program = std::make_shared<Program>(context_, loadSource(source).text);
+                program->build(device, options);
+            }
+            promise.set_value(program);
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+            // Let a later call retry
+            std::lock_guard<std::mutex> lock(mutex_);
+            programs_.erase(key);
+        }
+    }
+    return *future.get();
+}
+
+KernelPool& KernelCache::get(const Device& device, const std::string& source, const std::string& name,
+                             const std::string& options) {
+    const Program& program = getProgram(device, source, options);
+    const std::string key = programKey(device, source, options) + '\n' + name;
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<KernelPool>& pool = kernels_[key];
+    if (!pool) {
+        try {
+            pool.reset(new KernelPool(program, name));
+        } catch (...) {
+            kernels_.erase(key);
+            throw;
+        }
+    }
+    return *pool;
+}
+
+void KernelCache::warmup(const Device& device, const std::vector<KernelKey>& kernels, size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, kernels.size());
+    
+    std::atomic<size_t> next{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    auto worker = [&]() {
+        for (size_t i = next++; i < kernels.size(); i = next++) {
+            try {
+                get(device, kernels[i].source, kernels[i].name, kernels[i].options);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+size_t KernelCache::getProgramCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return programs_.size();
+}
+
+} // namespace ocl
@@ -0,0 +1,106 @@
+#include <ocl/KernelFunctor.hpp>
+#include <stdexcept>
+
+namespace ocl {
+
+namespace {
+
+// Returns false if the program was built without -cl-kernel-arg-info
+bool getArgString(cl_kernel kernel, cl_uint index, cl_kernel_arg_info param, std::string& result) {
+    size_t size;
+    cl_int err = clGetKernelArgInfo(kernel, index, param, 0, nullptr, &size);
+    if (err == CL_KERNEL_ARG_INFO_NOT_AVAILABLE) {
+        return false;
+    }
+    checkError(err, "getting kernel arg info size");
+    
+    result.assign(size, '\0');
+    err = clGetKernelArgInfo(kernel, index, param, size, &result[0], nullptr);
+    checkError(err, "getting kernel arg info");
+    
+    if (!result.empty() && result.back() == '\0') {
+        result.pop_back();
+    }
+    return true;
+}
+
+// Drivers differ in spelling ("unsigned int" vs "uint", "float *" vs "float*")
+std::string normalizeTypeName(std::string type) {
+    const std::string unsigned_prefix = "unsigned ";
+    if (type.compare(0, unsigned_prefix.size(), unsigned_prefix) == 0) {
+        type = "u" + type.substr(unsigned_prefix.size());
+    }
+    std::string result;
+    for (char c : type) {
+        if (c != ' ') result += c;
+    }
+    return result;
+}
+
+const char* addressName(cl_kernel_arg_address_qualifier address) {
+    switch (address) {
+        case CL_KERNEL_ARG_ADDRESS_GLOBAL: return "__global";
+        case CL_KERNEL_ARG_ADDRESS_LOCAL: return "__local";
+        case CL_KERNEL_ARG_ADDRESS_CONSTANT: return "__constant";
+        default: return "__private";
+    }
+}
+
+} // namespace
+
+void validateKernelArgs(cl_kernel kernel, const std::vector<KernelArgSpec>& expected) {
+    const std::string name = detail::kernelName(kernel);
+    
+    cl_uint num_args;
+    cl_int err = clGetKernelInfo(kernel, CL_KERNEL_NUM_ARGS, sizeof(cl_uint), &num_args, nullptr);
+    checkError(err, "getting kernel arg count");
+    
+    if (num_args != expected.size()) {
+        throw std::invalid_argument("Kernel " + name + " takes " + std::to_string(num_args) +
+                                    " arguments, signature has " + std::to_string(expected.size()));
+    }
+    
+    for (cl_uint i = 0; i < num_args; ++i) {
+        std::string type;
+        if (!getArgString(kernel, i, CL_KERNEL_ARG_TYPE_NAME, type)) {
+            return;  // No argument info: only the count can be checked
+        }
+        std::string arg_name;
+        getArgString(kernel, i, CL_KERNEL_ARG_NAME, arg_name);
+        
+        cl_kernel_arg_address_qualifier address;
+        err = clGetKernelArgInfo(kernel, i, CL_KERNEL_ARG_ADDRESS_QUALIFIER, sizeof(address), &address, nullptr);
+        checkError(err, "getting kernel arg address qualifier");
+        
+        // Buffers may be bound to __constant pointers as well
+        const KernelArgSpec& spec = expected[i];
+        bool address_ok = address == spec.address ||
+                          (spec.address == CL_KERNEL_ARG_ADDRESS_GLOBAL && address == CL_KERNEL_ARG_ADDRESS_CONSTANT);
+        
+        if (normalizeTypeName(type) != spec.type || !address_ok) {
+            throw std::invalid_argument("Kernel " + name + " argument " + std::to_string(i) + " (" + arg_name +
+                                        ") is " + addressName(address) + " " + type + ", signature passes " +
+                                        addressName(spec.address) + " " + spec.type);
+        }
+    }
+}
+
+std::vector<bool> getConstArgs(cl_kernel kernel) {
+    cl_uint num_args;
+    cl_int err = clGetKernelInfo(kernel, CL_KERNEL_NUM_ARGS, sizeof(cl_uint), &num_args, nullptr);
+    checkError(err, "getting kernel arg count");
+    
+    std::vector<bool> result(num_args);
+    for (cl_uint i = 0; i < num_args; ++i) {
+        cl_kernel_arg_type_qualifier qualifier;
+        err = clGetKernelArgInfo(kernel, i, CL_KERNEL_ARG_TYPE_QUALIFIER, sizeof(qualifier), &qualifier, nullptr);
+        if (err == CL_KERNEL_ARG_INFO_NOT_AVAILABLE) {
+            return {};
+        }
+        checkError(err, "getting kernel arg type qualifier");
+        result[i] = (qualifier & CL_KERNEL_ARG_TYPE_CONST) != 0;
+    }
+    return result;
+}
+
+} // namespace ocl
@@ -0,0 +1,178 @@
+#include <ocl/KernelPool.hpp>
+#include <ocl/Program.hpp>
+#include <ocl/Device.hpp>
+#include <ocl/Instrument.hpp>
+#include <ocl/Metrics.hpp>
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace ocl {
+
+namespace {
+
+const size_t kOverflow = static_cast<size_t>(-1);
+
+// clCloneKernel needs OpenCL 2.1 on the device and in the headers
+bool canClone(cl_program program) {
+#if CL_TARGET_OPENCL_VERSION >= 210
+    cl_device_id device;
+    cl_int err = clGetProgramInfo(program, CL_PROGRAM_DEVICES, sizeof(cl_device_id), &device, nullptr);
+    checkError(err, "getting program devices");
+    return Device(device).getVersionNumber() >= 210;
+#else
+    (void)program;
+    return false;
+#endif
+}
+
+// Threads start scanning at different slots to avoid contending on slot 0
+size_t threadHint() {
+    static thread_local size_t hint = std::hash<std::thread::id>()(std::this_thread::get_id());
+    return hint;
+}
+
+} // namespace
+
+// ============================================================================
+// Lease
+// ============================================================================
+
+KernelPool::Lease::Lease(KernelPool* pool, Kernel* kernel, size_t slot, std::unique_ptr<Kernel> overflow)
+    : pool_(pool), kernel_(kernel), slot_(slot), overflow_(std::move(overflow)) {}
+
+KernelPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), kernel_(other.kernel_), slot_(other.slot_), overflow_(std::move(other.overflow_)) {
+    other.pool_ = nullptr;
+    other.kernel_ = nullptr;
+}
+
+KernelPool::Lease& KernelPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        kernel_ = other.kernel_;
+        slot_ = other.slot_;
+        overflow_ = std::move(other.overflow_);
+        other.pool_ = nullptr;
+        other.kernel_ = nullptr;
+    }
+    return *this;
+}
+
+KernelPool::Lease::~Lease() {
+    release();
+}
+
+void KernelPool::Lease::release() {
+    if (pool_) {
+        pool_->release(slot_, std::move(overflow_));
+        pool_ = nullptr;
+        kernel_ = nullptr;
+    }
+}
+
+// ============================================================================
+// KernelPool
+// ============================================================================
+
+KernelPool::KernelPool(const Program& program, const std::string& name, size_t capacity)
+    : program_(program.get())
+    , name_(name)
+    , prototype_(program, name)
+    , use_clone_(canClone(program.get()))
+    , capacity_(capacity > 0 ? capacity : std::max(1u, std::thread::hardware_concurrency()))
+    , slots_(new Slot[capacity_])
+    , instances_(0) {
+    
+    // Instances are created from the program after the caller's Program may be gone
+    clRetainProgram(program_);
+}
+
+KernelPool::~KernelPool() {
+    // Release kernels before the program they belong to
+    slots_.reset();
+    overflow_.clear();
+    prototype_ = Kernel();
+    clReleaseProgram(program_);
+}
+
+Kernel KernelPool::createInstance() {
+    cl_int err;
+    cl_kernel kernel;
+#if CL_TARGET_OPENCL_VERSION >= 210
+    if (use_clone_) {
+        kernel = clCloneKernel(prototype_.get(), &err);
+        checkError(err, "cloning kernel: " + name_);
+    } else
+#endif
+    {
+        kernel = clCreateKernel(program_, name_.c_str(), &err);
+        checkError(err, "creating kernel: " + name_);
+    }
+    instances_.fetch_add(1, std::memory_order_relaxed);
+    detail::recordPoolAcquire(false);
+    return Kernel(kernel);
+}
+
+KernelPool::Lease KernelPool::acquire() {
+    OCL_PROFILE_SCOPE("KernelPool::acquire");
+    const size_t start = threadHint() % capacity_;
+    
+    // Fast path: reuse a created instance
+    for (size_t i = 0; i < capacity_; ++i) {
+        const size_t index = (start + i) % capacity_;
+        Slot& slot = slots_[index];
+        int expected = Free;
+        if (slot.state.load(std::memory_order_relaxed) == Free &&
+            slot.state.compare_exchange_strong(expected, InUse, std::memory_order_acquire)) {
+            detail::recordPoolAcquire(true);
+            return Lease(this, &slot.kernel, index, nullptr);
+        }
+    }
+    
+    // Claim an empty slot and create its instance
+    for (size_t i = 0; i < capacity_; ++i) {
+        const size_t index = (start + i) % capacity_;
+        Slot& slot = slots_[index];
+        int expected = Empty;
+        if (slot.state.load(std::memory_order_relaxed) == Empty &&
+            slot.state.compare_exchange_strong(expected, InUse, std::memory_order_acquire)) {
+            try {
+                slot.kernel = createInstance();
+            } catch (...) {
+                slot.state.store(Empty, std::memory_order_release);
+                throw;
+            }
+            return Lease(this, &slot.kernel, index, nullptr);
+        }
+    }
+    
+    // All slots busy: overflow instances, kept on a locked free list
+    std::unique_ptr<Kernel> kernel;
+    {
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        if (!overflow_.empty()) {
+            kernel = std::move(overflow_.back());
+            overflow_.pop_back();
+        }
+    }
+    if (kernel) {
+        detail::recordPoolAcquire(true);
+    } else {
+        kernel.reset(new Kernel(createInstance()));
+    }
+    Kernel* ptr = kernel.get();
+    return Lease(this, ptr, kOverflow, std::move(kernel));
+}
+
+void KernelPool::release(size_t slot, std::unique_ptr<Kernel> overflow) {
+    if (slot != kOverflow) {
+        slots_[slot].state.store(Free, std::memory_order_release);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(overflow_mutex_);
+    overflow_.push_back(std::move(overflow));
+}
+
+} // namespace ocl
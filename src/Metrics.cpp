@@ -0,0 +1,460 @@
+#include <ocl/Metrics.hpp>
+#include <ocl/Buffer.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace ocl {
+
+// ============================================================================
+// Histogram
+// ============================================================================
+
+Histogram::Histogram(std::vector<double> bounds) : bounds_(std::move(bounds)) {
+    std::sort(bounds_.begin(), bounds_.end());
+    buckets_.reset(new std::atomic<uint64_t>[bounds_.size() + 1]);
+    for (size_t i = 0; i <= bounds_.size(); ++i) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::observe(double value, uint64_t weight) {
+    size_t index = std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+    buckets_[index].fetch_add(weight, std::memory_order_relaxed);
+    count_.fetch_add(weight, std::memory_order_relaxed);
+    
+    double sum = sum_.load(std::memory_order_relaxed);
+    while (!sum_.compare_exchange_weak(sum, sum + value * weight, std::memory_order_relaxed)) {
+    }
+}
+
+// ============================================================================
+// KernelSampler
+// ============================================================================
+
+namespace {
+
+int64_t steadyNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+void KernelSampler::configure(const KernelSampling& config) {
+    const uint32_t period = std::max<uint32_t>(1, config.period);
+    period_.store(period, std::memory_order_relaxed);
+    max_period_.store(std::max(period, config.max_period), std::memory_order_relaxed);
+    target_rate_.store(config.target_rate, std::memory_order_relaxed);
+    countdown_.store(period, std::memory_order_relaxed);
+}
+
+void KernelSampler::adapt(uint32_t weight) {
+    if (adapting_.test_and_set(std::memory_order_acquire)) {
+        return;
+    }
+    const int64_t now = steadyNanoseconds();
+    if (window_start_ns_ == 0) {
+        window_start_ns_ = now;
+    }
+    window_launches_ += weight;
+    
+    const double elapsed = (now - window_start_ns_) * 1e-9;
+    const double target = target_rate_.load(std::memory_order_relaxed);
+    if (elapsed >= 1.0 && target > 0.0) {
+        const double launch_rate = window_launches_ / elapsed;
+        const double period = std::min<double>(std::max(1.0, launch_rate / target),
+                                               max_period_.load(std::memory_order_relaxed));
+        period_.store(static_cast<uint32_t>(period + 0.5), std::memory_order_relaxed);
+        window_launches_ = 0;
+        window_start_ns_ = now;
+    }
+    adapting_.clear(std::memory_order_release);
+}
+
+// ============================================================================
+// Metrics
+// ============================================================================
+
+namespace {
+
+std::string escapeLabel(const std::string& value) {
+    std::string result;
+    for (char c : value) {
+        switch (c) {
+            case '\\': result += "\\\\"; break;
+            case '"': result += "\\\""; break;
+            case '\n': result += "\\n"; break;
+            default: result += c;
+        }
+    }
+    return result;
+}
+
+// {a="1",b="2"} with an optional extra label (e.g. le for buckets)
+std::string formatLabels(const Metrics::Labels& labels, const std::string& extra = "") {
+    if (labels.empty() && extra.empty()) {
+        return "";
+    }
+    std::string result = "{";
+    for (const auto& label : labels) {
+        if (result.size() > 1) result += ",";
+        result += label.first + "=\"" + escapeLabel(label.second) + "\"";
+    }
+    if (!extra.empty()) {
+        if (result.size() > 1) result += ",";
+        result += extra;
+    }
+    return result + "}";
+}
+
+std::string formatNumber(double value) {
+    std::ostringstream out;
+    out.precision(12);
+    out << value;
+    return out.str();
+}
+
+} // namespace
+
+Metrics& Metrics::instance() {
+    static Metrics metrics;
+    return metrics;
+}
+
+namespace {
+
+// Per-kernel timing state, created on a kernel's first timed launch
+struct TimingRegistry {
+    std::mutex mutex;
+    KernelSampling defaults;
+    std::map<std::string, KernelSampling> overrides;
+    std::map<std::string, std::unique_ptr<detail::KernelTiming>> kernels;
+    
+    const KernelSampling& samplingFor(const std::string& name) const {
+        auto it = overrides.find(name);
+        return it != overrides.end() ? it->second : defaults;
+    }
+};
+
+TimingRegistry& timingRegistry() {
+    static TimingRegistry registry;
+    return registry;
+}
+
+} // namespace
+
+void Metrics::setKernelSampling(const KernelSampling& sampling) {
+    TimingRegistry& registry = timingRegistry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.defaults = sampling;
+        for (auto& entry : registry.kernels) {
+            entry.second->sampler.configure(registry.samplingFor(entry.first));
+        }
+    }
+    setKernelTiming(true);
+}
+
+void Metrics::setKernelSampling(const std::string& kernel, const KernelSampling& sampling) {
+    TimingRegistry& registry = timingRegistry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.overrides[kernel] = sampling;
+        auto it = registry.kernels.find(kernel);
+        if (it != registry.kernels.end()) {
+            it->second->sampler.configure(sampling);
+        }
+    }
+    setKernelTiming(true);
+}
+
+std::vector<double> Metrics::defaultBuckets() {
+    return {1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4, 1e-3, 2.5e-3, 5e-3,
+            1e-2, 2.5e-2, 5e-2, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+}
+
+Metrics::Series& Metrics::getSeries(const std::string& name, const std::string& help, Type type, const Labels& labels) {
+    // Caller holds mutex_
+    auto it = families_.find(name);
+    if (it == families_.end()) {
+        it = families_.emplace(name, Family{type, help, {}}).first;
+    } else if (it->second.type != type) {
+        throw std::invalid_argument("Metric " + name + " is already registered with another type");
+    }
+    
+    Series& series = it->second.series[formatLabels(labels)];
+    series.labels = labels;
+    return series;
+}
+
+Counter& Metrics::counter(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series& series = getSeries(name, help, Type::Counter, labels);
+    if (!series.counter) {
+        series.counter.reset(new Counter());
+    }
+    return *series.counter;
+}
+
+Gauge& Metrics::gauge(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series& series = getSeries(name, help, Type::Gauge, labels);
+    if (!series.gauge) {
+        series.gauge.reset(new Gauge());
+    }
+    return *series.gauge;
+}
+
+Histogram& Metrics::histogram(const std::string& name, const std::string& help, const Labels& labels,
+                              const std::vector<double>& bounds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series& series = getSeries(name, help, Type::Histogram, labels);
+    if (!series.histogram) {
+        series.histogram.reset(new Histogram(bounds));
+    }
+    return *series.histogram;
+}
+
+std::string Metrics::render() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream out;
+    
+    for (const auto& entry : families_) {
+        const std::string& name = entry.first;
+        const Family& family = entry.second;
+        const char* type = family.type == Type::Counter ? "counter" :
+                           family.type == Type::Gauge ? "gauge" : "histogram";
+        out << "# TYPE " << name << " " << type << "\n";
+        out << "# HELP " << name << " " << family.help << "\n";
+        
+        for (const auto& item : family.series) {
+            const Series& series = item.second;
+            const std::string& labels = item.first;
+            if (series.counter) {
+                out << name << "_total" << labels << " " << series.counter->value() << "\n";
+            } else if (series.gauge) {
+                out << name << labels << " " << series.gauge->value() << "\n";
+            } else if (series.histogram) {
+                // Buckets are cumulative in the exposition format
+                const Histogram& h = *series.histogram;
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i < h.getBounds().size(); ++i) {
+                    cumulative += h.getBucketCount(i);
+                    out << name << "_bucket" << formatLabels(series.labels, "le=\"" + formatNumber(h.getBounds()[i]) + "\"")
+                        << " " << cumulative << "\n";
+                }
+                cumulative += h.getBucketCount(h.getBounds().size());
+                out << name << "_bucket" << formatLabels(series.labels, "le=\"+Inf\"") << " " << cumulative << "\n";
+                out << name << "_count" << labels << " " << h.getCount() << "\n";
+                out << name << "_sum" << labels << " " << formatNumber(h.getSum()) << "\n";
+            }
+        }
+    }
+    out << "# EOF\n";
+    return out.str();
+}
+
+// ============================================================================
+// MetricsServer
+// ============================================================================
+
+#ifndef _WIN32
+
+MetricsServer::MetricsServer(uint16_t port, const std::string& address) : socket_(-1), port_(port), stopping_(false) {
+    socket_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (socket_ < 0) {
+        throw std::runtime_error(std::string("Cannot create metrics socket: ") + std::strerror(errno));
+    }
+    int reuse = 1;
+    setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        ::close(socket_);
+        throw std::invalid_argument("Invalid metrics address: " + address);
+    }
+    if (::bind(socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(socket_, 16) < 0) {
+        std::string reason = std::strerror(errno);
+        ::close(socket_);
+        throw std::runtime_error("Cannot listen on " + address + ":" + std::to_string(port) + ": " + reason);
+    }
+    
+    socklen_t length = sizeof(addr);
+    getsockname(socket_, reinterpret_cast<sockaddr*>(&addr), &length);
+    port_ = ntohs(addr.sin_port);
+    
+    thread_ = std::thread(&MetricsServer::run, this);
+}
+
+MetricsServer::~MetricsServer() {
+    stopping_.store(true);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    ::close(socket_);
+}
+
+void MetricsServer::run() {
+    while (!stopping_.load()) {
+        // Wake up regularly to notice shutdown
+        pollfd listener{socket_, POLLIN, 0};
+        if (poll(&listener, 1, 100) <= 0) {
+            continue;
+        }
+        int client = ::accept(socket_, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+        
+        // Read the request head (a scrape has no body)
+        std::string request;
+        char buffer[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+            pollfd readable{client, POLLIN, 0};
+            if (poll(&readable, 1, 1000) <= 0) break;
+            ssize_t received = ::recv(client, buffer, sizeof(buffer), 0);
+            if (received <= 0) break;
+            request.append(buffer, static_cast<size_t>(received));
+        }
+        
+        std::string status, body, type = "text/plain; charset=utf-8";
+        if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 13, "GET /metrics?") == 0) {
+            status = "200 OK";
+            body = Metrics::instance().render();
+            type = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+        } else {
+            status = "404 Not Found";
+            body = "Not found\n";
+        }
+        std::string response = "HTTP/1.1 " + status + "\r\nContent-Type: " + type +
+                               "\r\nContent-Length: " + std::to_string(body.size()) +
+                               "\r\nConnection: close\r\n\r\n" + body;
+        
+        size_t sent = 0;
+        while (sent < response.size()) {
+            ssize_t n = ::send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) break;
+            sent += static_cast<size_t>(n);
+        }
+        ::close(client);
+    }
+}
+
+#else
+
+MetricsServer::MetricsServer(uint16_t port, const std::string&) : socket_(-1), port_(port), stopping_(false) {
+    throw std::runtime_error("MetricsServer is not supported on this platform; serve Metrics::render() instead");
+}
+
+MetricsServer::~MetricsServer() {}
+
+void MetricsServer::run() {}
+
+#endif
+
+// ============================================================================
+// Library hooks
+// ============================================================================
+
+namespace detail {
+
+namespace {
+
+struct PendingSample {
+    Histogram* histogram;
+    uint64_t weight;
+};
+
+void CL_CALLBACK onKernelComplete(cl_event event, cl_int status, void* data) {
+    std::unique_ptr<PendingSample> sample(static_cast<PendingSample*>(data));
+    if (status == CL_COMPLETE) {
+        cl_ulong start = 0, end = 0;
+        if (clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(start), &start, nullptr) == CL_SUCCESS &&
+            clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(end), &end, nullptr) == CL_SUCCESS) {
+            sample->histogram->observe((end - start) * 1e-9, sample->weight);
+        }
+    }
+    clReleaseEvent(event);
+}
+
+} // namespace
+
+Counter& kernelLaunchCounter(const std::string& name) {
+    return Metrics::instance().counter("ocl_kernel_launches", "Kernel launches", {{"kernel", name}});
+}
+
+KernelTiming& kernelTiming(const std::string& name) {
+    TimingRegistry& registry = timingRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::unique_ptr<KernelTiming>& timing = registry.kernels[name];
+    if (!timing) {
+        Histogram& durations = Metrics::instance().histogram(
+            "ocl_kernel_duration_seconds", "Kernel device time (event profiling, sampled)", {{"kernel", name}});
+        timing.reset(new KernelTiming(durations, registry.samplingFor(name)));
+    }
+    return *timing;
+}
+
+void observeKernelDuration(cl_event event, Histogram& histogram, uint64_t weight) {
+    // The callback owns one event reference and the sample until it runs
+    std::unique_ptr<PendingSample> sample(new PendingSample{&histogram, weight});
+    clRetainEvent(event);
+    if (clSetEventCallback(event, CL_COMPLETE, onKernelComplete, sample.get()) == CL_SUCCESS) {
+        sample.release();
+    } else {
+        clReleaseEvent(event);
+    }
+}
+
+void recordPoolAcquire(bool hit) {
+    static Counter& hits = Metrics::instance().counter("ocl_kernel_pool_acquires", "KernelPool acquisitions",
+                                                       {{"result", "hit"}});
+    static Counter& misses = Metrics::instance().counter("ocl_kernel_pool_acquires", "KernelPool acquisitions",
+                                                         {{"result", "miss"}});
+    (hit ? hits : misses).inc();
+}
+
+void recordProgramCache(bool hit) {
+    static Counter& hits = Metrics::instance().counter("ocl_program_cache_lookups", "Program variant cache lookups",
+                                                       {{"result", "hit"}});
+    static Counter& misses = Metrics::instance().counter("ocl_program_cache_lookups", "Program variant cache lookups",
+                                                         {{"result", "miss"}});
+    (hit ? hits : misses).inc();
+}
+
+void recordProgramBuild(double seconds) {
+    static Histogram& builds = Metrics::instance().histogram("ocl_program_build_seconds", "Program build time");
+    builds.observe(seconds);
+}
+
+void recordTransfer(TransferDirection direction, size_t bytes) {
+    static Counter* counters[] = {
+        &Metrics::instance().counter("ocl_transfer_bytes", "Bytes moved by Buffer operations", {{"direction", "host_to_device"}}),
+        &Metrics::instance().counter("ocl_transfer_bytes", "Bytes moved by Buffer operations", {{"direction", "device_to_host"}}),
+        &Metrics::instance().counter("ocl_transfer_bytes", "Bytes moved by Buffer operations", {{"direction", "device_to_device"}}),
+    };
+    counters[static_cast<int>(direction)]->inc(bytes);
+}
+
+void recordDeviceMemory(int64_t delta) {
+    static Gauge& live = Metrics::instance().gauge("ocl_device_memory_bytes", "Device memory held by live Buffers");
+    live.add(delta);
+}
+
+} // namespace detail
+
+} // namespace ocl
@@ -6,21 +6,113 @@
 
 namespace ocl {
 
-size_t NDRange::getOptimal1D(const Kernel& kernel, const Device& device, size_t global_size) {
-    // Get kernel work group info
-    size_t max_work_group = kernel.getWorkGroupSize(device);
-    size_t preferred_multiple = kernel.getPreferredWorkGroupSizeMultiple(device);
+namespace {
+
+// Occupancy model (see Occupancy in NDRange.hpp)
+const size_t kResidentPerMaxWorkGroup = 2;
+const size_t kMaxWorkGroupsPerCU = 16;
+
+struct DeviceLimits {
+    size_t max_work_group;
+    cl_ulong local_mem;
+};
+
+DeviceLimits queryLimits(const Device& device) {
+    return {device.getMaxWorkGroupSize(), device.getLocalMemSize()};
+}
+
+// The KernelInfo fields work-group selection needs (skips name and spill queries)
+KernelInfo queryLaunchInfo(const Kernel& kernel, const Device& device) {
+    KernelInfo info;
+    info.work_group_size = kernel.getWorkGroupSize(device);
+    info.preferred_multiple = kernel.getPreferredWorkGroupSizeMultiple(device);
+    info.local_mem_size = kernel.getLocalMemSize(device);
+    cl_int err = clGetKernelWorkGroupInfo(kernel.get(), device.id(), CL_KERNEL_COMPILE_WORK_GROUP_SIZE,
+                                          sizeof(info.compile_work_group_size), info.compile_work_group_size, nullptr);
+    checkError(err, "getting kernel compile work group size");
+    return info;
+}
+
+Occupancy estimate(const KernelInfo& info, const DeviceLimits& limits, size_t local_size, size_t local_mem_bytes) {
+    Occupancy result;
+    const size_t kernel_max = info.work_group_size > 0 ? info.work_group_size : limits.max_work_group;
+    if (local_size == 0 || local_size > kernel_max) {
+        result.limiter = "work-group size";
+        return result;
+    }
+    const cl_ulong local_mem = info.local_mem_size + local_mem_bytes;
+    if (local_mem > limits.local_mem) {
+        result.limiter = "local memory";
+        return result;
+    }
     
-    // Start with preferred multiple
-    size_t local_size = preferred_multiple;
+    const size_t slots = NDRange::roundUp(local_size, std::max(size_t(1), info.preferred_multiple));
+    const size_t max_items = kResidentPerMaxWorkGroup * limits.max_work_group;
+    
+    size_t groups = kMaxWorkGroupsPerCU;
+    result.limiter = "work-groups";
+    auto limit = [&](size_t bound, const char* limiter) {
+        if (bound < groups) {
+            groups = bound;
+            result.limiter = limiter;
+        }
+    };
+    limit(max_items / slots, "work-items");
+    if (kernel_max < limits.max_work_group) {
+        limit(kernel_max / slots, "registers");
+    }
+    if (local_mem > 0) {
+        limit(static_cast<size_t>(limits.local_mem / local_mem), "local memory");
+    }
     
-    // Scale up to a reasonable size (but not too large)
+    result.work_groups_per_cu = groups;
+    result.resident_work_items = groups * local_size;
+    result.occupancy = std::min(1.0, static_cast<double>(result.resident_work_items) / max_items);
+    return result;
+}
+
+} // namespace
+
+size_t NDRange::getOptimal1D(const Kernel& kernel, const Device& device, size_t global_size,
+                             size_t local_mem_per_item) {
+    const KernelInfo info = queryLaunchInfo(kernel, device);
+    if (info.hasCompileWorkGroupSize()) {
+        return info.compile_work_group_size[0];
+    }
+    const DeviceLimits limits = queryLimits(device);
+    size_t max_work_group = info.work_group_size;
+    size_t preferred_multiple = info.preferred_multiple;
+    
+    // Preferred multiple scaled by powers of two (but not too large), keeping
+    // the most resident. The caller pads the global size, so a size that
+    // divides it only wins ties, then the larger size does
+    size_t best_size = 0;
+    double best_occupancy = 0.0;
+    bool best_divides = false;
+    for (size_t size = std::max(size_t(1), preferred_multiple); size <= max_work_group && size <= 1024; size *= 2) {
+        const Occupancy occupancy = estimate(info, limits, size, local_mem_per_item * size);
+        if (occupancy.work_groups_per_cu == 0) {
+            continue;
+        }
+        const bool divides = global_size % size == 0;
+        if (best_size == 0 || occupancy.occupancy > best_occupancy ||
+            (occupancy.occupancy == best_occupancy && divides >= best_divides)) {
+            best_size = size;
+            best_occupancy = occupancy.occupancy;
+            best_divides = divides;
+        }
+    }
+    if (best_size > 0) {
+        return best_size;
+    }
+    
+    // No candidate fits (e.g. too much local memory): the largest divisor of
+    // the global size that's <= the scaled-up preferred multiple
+    size_t local_size = preferred_multiple;
     while (local_size * 2 <= max_work_group && local_size * 2 <= 1024) {
         local_size *= 2;
     }
-    
-    // Find the largest divisor of global_size that's <= local_size
-    size_t best_size = findBestDivisor(global_size, local_size);
+    best_size = findBestDivisor(global_size, local_size);
     
     // Ensure it's a multiple of preferred_multiple
     if (preferred_multiple > 1) {
@@ -34,9 +126,14 @@ size_t NDRange::getOptimal1D(const Kernel& kernel, const Device& device, size_t
 }
 
 std::array<size_t, 2> NDRange::getOptimal2D(const Kernel& kernel, const Device& device,
-                                             size_t global_x, size_t global_y) {
-    size_t max_work_group = kernel.getWorkGroupSize(device);
-    size_t preferred_multiple = kernel.getPreferredWorkGroupSizeMultiple(device);
+                                             size_t global_x, size_t global_y,
+                                             size_t local_mem_per_item) {
+    const KernelInfo info = queryLaunchInfo(kernel, device);
+    if (info.hasCompileWorkGroupSize()) {
+        return {info.compile_work_group_size[0], info.compile_work_group_size[1]};
+    }
+    const DeviceLimits limits = queryLimits(device);
+    size_t max_work_group = info.work_group_size;
     
     // Common 2D work group sizes
     std::array<std::array<size_t, 2>, 6> candidates = {{
@@ -48,16 +145,24 @@ std::array<size_t, 2> NDRange::getOptimal2D(const Kernel& kernel, const Device&
         {8, 16}     // 128 total
     }};
     
-    // Find best candidate
+    // Find the most resident candidate (earlier ones win ties)
+    const std::array<size_t, 2>* best = nullptr;
+    double best_occupancy = 0.0;
     for (const auto& candidate : candidates) {
         size_t total = candidate[0] * candidate[1];
         if (total <= max_work_group &&
             (global_x % candidate[0] == 0) &&
             (global_y % candidate[1] == 0)) {
-            return candidate;
+            const Occupancy occupancy = estimate(info, limits, total, local_mem_per_item * total);
+            if (occupancy.work_groups_per_cu > 0 && (!best || occupancy.occupancy > best_occupancy)) {
+                best = &candidate;
+                best_occupancy = occupancy.occupancy;
+            }
         }
     }
-    
+    if (best) {
+        return *best;
+    }
     // Fallback: try to find any valid sizes
     size_t local_x = std::min(size_t(16), global_x);
     size_t local_y = std::min(size_t(16), global_y);
@@ -76,8 +181,14 @@ std::array<size_t, 2> NDRange::getOptimal2D(const Kernel& kernel, const Device&
 }
 
 std::array<size_t, 3> NDRange::getOptimal3D(const Kernel& kernel, const Device& device,
-                                             size_t global_x, size_t global_y, size_t global_z) {
-    size_t max_work_group = kernel.getWorkGroupSize(device);
+                                             size_t global_x, size_t global_y, size_t global_z,
+                                             size_t local_mem_per_item) {
+    const KernelInfo info = queryLaunchInfo(kernel, device);
+    if (info.hasCompileWorkGroupSize()) {
+        return {info.compile_work_group_size[0], info.compile_work_group_size[1], info.compile_work_group_size[2]};
+    }
+    const DeviceLimits limits = queryLimits(device);
+    size_t max_work_group = info.work_group_size;
     
     // For 3D, use smaller work groups
     std::array<std::array<size_t, 3>, 4> candidates = {{
@@ -87,15 +198,24 @@ std::array<size_t, 3> NDRange::getOptimal3D(const Kernel& kernel, const Device&
         {4, 4, 4}    // 64 total
     }};
     
+    const std::array<size_t, 3>* best = nullptr;
+    double best_occupancy = 0.0;
     for (const auto& candidate : candidates) {
         size_t total = candidate[0] * candidate[1] * candidate[2];
         if (total <= max_work_group &&
             (global_x % candidate[0] == 0) &&
             (global_y % candidate[1] == 0) &&
             (global_z % candidate[2] == 0)) {
-            return candidate;
+            const Occupancy occupancy = estimate(info, limits, total, local_mem_per_item * total);
+            if (occupancy.work_groups_per_cu > 0 && (!best || occupancy.occupancy > best_occupancy)) {
+                best = &candidate;
+                best_occupancy = occupancy.occupancy;
+            }
         }
     }
+    if (best) {
+        return *best;
+    }
     
     // Fallback
     size_t local_x = std::min(size_t(4), global_x);
@@ -129,5 +249,15 @@ size_t NDRange::getPreferredMultiple(const Kernel& kernel, const Device& device)
     return kernel.getPreferredWorkGroupSizeMultiple(device);
 }
 
+Occupancy NDRange::estimateOccupancy(const Kernel& kernel, const Device& device,
+                                     size_t local_size, size_t local_mem_bytes) {
+    return estimate(queryLaunchInfo(kernel, device), queryLimits(device), local_size, local_mem_bytes);
+}
+
+Occupancy NDRange::estimateOccupancy(const KernelInfo& info, const Device& device,
+                                     size_t local_size, size_t local_mem_bytes) {
+    return estimate(info, queryLimits(device), local_size, local_mem_bytes);
+}
+
 } // namespace ocl
 
@@ -61,6 +61,117 @@ void Profiler::printResults() const {
 
 void Profiler::reset() {
     timings_.clear();
+    
+    std::lock_guard<std::mutex> lock(kernel_mutex_);
+    pending_.clear();
+    kernel_stats_.clear();
+}
+
+void Profiler::recordKernel(const std::string& name, const Event& event, const KernelCost& cost) {
+    std::lock_guard<std::mutex> lock(kernel_mutex_);
+    pending_.push_back({name, event.retain(), cost});
+    
+    // Keep the backlog (and the events it holds) bounded
+    if (pending_.size() >= 1024) {
+        collectLaunches(false);
+    }
+}
+
+void Profiler::collectLaunches(bool wait) {
+    auto keep = pending_.begin();
+    for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+        if (!wait && !it->event.isComplete()) {
+            if (keep != it) *keep = std::move(*it);
+            ++keep;
+            continue;
+        }
+        
+        KernelStats& stats = kernel_stats_[it->name];
+        stats.name = it->name;
+        stats.launches++;
+        try {
+            it->event.wait();
+            const double ms = it->event.getProfilingDurationMs();
+            stats.total_ms += ms;
+            stats.timed_launches++;
+            stats.cost.bytes_read += it->cost.bytes_read;
+            stats.cost.bytes_written += it->cost.bytes_written;
+            stats.cost.flops += it->cost.flops;
+        } catch (const Error&) {
+            // Failed launch or queue without profiling: counted, not timed
+        }
+    }
+    pending_.erase(keep, pending_.end());
+}
+
+std::vector<KernelStats> Profiler::getKernelStats() {
+    std::lock_guard<std::mutex> lock(kernel_mutex_);
+    collectLaunches(true);
+    
+    std::vector<KernelStats> result;
+    result.reserve(kernel_stats_.size());
+    for (const auto& entry : kernel_stats_) {
+        result.push_back(entry.second);
+    }
+    return result;
+}
+
+void Profiler::setDevicePeaks(double gb_per_s, double gflop_per_s) {
+    std::lock_guard<std::mutex> lock(kernel_mutex_);
+    peak_gb_per_s_ = gb_per_s;
+    peak_gflop_per_s_ = gflop_per_s;
+}
+
+void Profiler::printKernelResults() {
+    std::vector<KernelStats> stats = getKernelStats();
+    double peak_gb_per_s, peak_gflop_per_s;
+    {
+        std::lock_guard<std::mutex> lock(kernel_mutex_);
+        peak_gb_per_s = peak_gb_per_s_;
+        peak_gflop_per_s = peak_gflop_per_s_;
+    }
+    const bool peaks = peak_gb_per_s > 0 && peak_gflop_per_s > 0;
+    
+    std::cout << "\n";
+    std::cout << "═══════════════════════════════════════════════════════════════════════════════════════════\n";
+    std::cout << "  Kernel Results\n";
+    std::cout << "═══════════════════════════════════════════════════════════════════════════════════════════\n";
+    std::cout << std::left << std::setw(24) << "Kernel"
+              << std::right << std::setw(10) << "Launches"
+              << std::setw(12) << "Avg (ms)"
+              << std::setw(10) << "GB/s"
+              << std::setw(10) << "GFLOP/s"
+              << std::setw(10) << "FLOP/B";
+    if (peaks) {
+        std::cout << std::setw(8) << "Roof" << "  Bound";
+    }
+    std::cout << "\n";
+    std::cout << "───────────────────────────────────────────────────────────────────────────────────────────\n";
+    
+    for (const auto& k : stats) {
+        double avg = k.timed_launches > 0 ? k.total_ms / k.timed_launches : 0.0;
+        std::cout << std::left << std::setw(24) << k.name
+                  << std::right << std::setw(10) << k.launches
+                  << std::fixed << std::setprecision(4) << std::setw(12) << avg
+                  << std::setprecision(1) << std::setw(10) << k.getGBPerSecond()
+                  << std::setw(10) << k.getGFLOPPerSecond()
+                  << std::setprecision(2) << std::setw(10) << k.getIntensity();
+        if (peaks && k.total_ms > 0) {
+            // Below the ridge point the roof is bandwidth, above it compute
+            const double ridge = peak_gflop_per_s / peak_gb_per_s;
+            const bool memory_bound = k.getIntensity() < ridge;
+            const double fraction = memory_bound ? k.getGBPerSecond() / peak_gb_per_s
+                                                 : k.getGFLOPPerSecond() / peak_gflop_per_s;
+            std::cout << std::setprecision(0) << std::setw(7) << 100.0 * fraction << "%"
+                      << (memory_bound ? "  memory" : "  compute");
+        }
+        if (k.timed_launches < k.launches) {
+            std::cout << "  (" << k.launches - k.timed_launches << " untimed)";
+        }
+        std::cout << "\n";
+    }
+    std::cout << "═══════════════════════════════════════════════════════════════════════════════════════════\n";
+    std::cout << "\n";
 }
 
 } // namespace ocl
@@ -1,11 +1,30 @@
 #include <ocl/Program.hpp>
 #include <ocl/Context.hpp>
 #include <ocl/Device.hpp>
+#include <ocl/Embedded.hpp>
+#include <ocl/Instrument.hpp>
+#include <ocl/Kernel.hpp>
+#include <ocl/Metrics.hpp>
+#include <ocl/Reclaimer.hpp>
+#include <ocl/SourceLoader.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
+#include <iostream>
+#include <unordered_map>
 #include <vector>
 
 namespace ocl {
 
+// Specialized variants of a program, keyed by their full option string
+// (references into an unordered_map stay valid as it grows)
+struct Program::VariantCache {
+    std::unordered_map<std::string, Program> entries;
+};
+
 Program::Program() : program_(nullptr) {}
 
 Program::Program(const Context& context, const std::string& source) {
@@ -26,36 +45,205 @@ Program Program::fromFile(const Context& context, const std::string& filepath) {
     return Program(context, source);
 }
 
+Program Program::fromEmbedded(const Context& context, const std::string& name) {
+    // Includes of embedded headers are inlined; the driver cannot see them
+    KernelSource source = SourceLoader().loadEmbedded(name);
+    
+    Program prog;
+    const char* src = source.text.c_str();
+    size_t length = source.text.size();
+    
+    cl_int err;
+    prog.program_ = clCreateProgramWithSource(context.get(), 1, &src, &length, &err);
+    checkError(err, "creating program from embedded source: " + name);
+    return prog;
+}
+
+Program Program::buildEmbedded(const Context& context, const Device& device, const std::string& name,
+                               const std::string& options) {
+    // Binaries and SPIR-V were compiled at embed time with default options:
+    // any options (-D defines in particular) require the source
+    if (!options.empty()) {
+        Program prog = fromEmbedded(context, name);
+        prog.build(device, options);
+        return prog;
+    }
+    
+    // Precompiled binary for this exact device, if one was embedded
+    const EmbeddedFile* binary = findEmbedded(name, EmbeddedFile::Binary, device.getName());
+    if (binary) {
+        try {
+            return fromBinary(context, device, binary->data, binary->size);
+        } catch (const Error&) {
+            // Driver rejected the binary (e.g. different driver version) - try the next form
+        }
+    }
+    
+    // SPIR-V skips the front end; devices may still reject modules that use
+    // capabilities they lack, so fall back to the source on failure
+    const EmbeddedFile* il = findEmbedded(name, EmbeddedFile::IL);
+    if (il && device.supportsIL()) {
+        try {
+            Program prog = fromIL(context, il->data, il->size);
+            prog.build(device);
+            return prog;
+        } catch (const Error&) {
+        }
+    }
+    
+    Program prog = fromEmbedded(context, name);
+    prog.build(device);
+    return prog;
+}
+
+namespace {
+
+using CreateProgramWithILKHR = cl_program (CL_API_CALL*)(cl_context, const void*, size_t, cl_int*);
+
+cl_device_id firstDevice(cl_context context) {
+    cl_device_id device = nullptr;
+    cl_int err = clGetContextInfo(context, CL_CONTEXT_DEVICES, sizeof(cl_device_id), &device, nullptr);
+    checkError(err, "getting context devices");
+    return device;
+}
+
+} // namespace
+
+Program Program::fromIL(const Context& context, const void* il, size_t size) {
+    if (!il || size == 0) {
+        throw std::invalid_argument("Cannot create program with empty IL");
+    }
+    
+    Device device(firstDevice(context.get()));
+    Program prog;
+    cl_int err = CL_INVALID_OPERATION;
+
+#if CL_TARGET_OPENCL_VERSION >= 210
+    if (device.getVersionNumber() >= 210 && !device.getILVersion().empty()) {
+        prog.program_ = clCreateProgramWithIL(context.get(), il, size, &err);
+        checkError(err, "creating program from IL");
+        return prog;
+    }
+#endif
+
+    if (!device.hasExtension("cl_khr_il_program")) {
+        throw Error(err, "creating program from IL (device does not accept IL)");
+    }
+    
+    // Extension entry points are resolved per platform
+    cl_platform_id platform;
+    err = clGetDeviceInfo(device.id(), CL_DEVICE_PLATFORM, sizeof(cl_platform_id), &platform, nullptr);
+    checkError(err, "getting device platform");
+    auto create = reinterpret_cast<CreateProgramWithILKHR>(
+        clGetExtensionFunctionAddressForPlatform(platform, "clCreateProgramWithILKHR"));
+    if (!create) {
+        throw Error(CL_INVALID_OPERATION, "creating program from IL (clCreateProgramWithILKHR not found)");
+    }
+    
+    prog.program_ = create(context.get(), il, size, &err);
+    checkError(err, "creating program from IL");
+    return prog;
+}
+
+Program Program::fromIL(const Context& context, const std::vector<unsigned char>& il) {
+    return fromIL(context, il.data(), il.size());
+}
+
+Program Program::fromILFile(const Context& context, const std::string& filepath) {
+    std::string il = readFile(filepath);
+    return fromIL(context, il.data(), il.size());
+}
+
 Program::~Program() {
     if (program_) {
-        clReleaseProgram(program_);
+        detail::releaseProgram(program_);
     }
 }
 
-Program::Program(Program&& other) noexcept : program_(other.program_) {
+Program::Program(Program&& other) noexcept : program_(other.program_), variants_(std::move(other.variants_)) {
     other.program_ = nullptr;
 }
 
 Program& Program::operator=(Program&& other) noexcept {
     if (this != &other) {
         if (program_) {
-            clReleaseProgram(program_);
+            detail::releaseProgram(program_);
         }
         program_ = other.program_;
+        variants_ = std::move(other.variants_);
         other.program_ = nullptr;
     }
     return *this;
 }
 
+namespace {
+
+std::atomic<bool> g_spill_warnings{false};
+
+// Spill sizes come from an Intel query; other drivers are not asked
+void warnSpills(const Program& program, const Device& device) {
+    if (!g_spill_warnings.load(std::memory_order_relaxed) || device.getVendor().find("Intel") == std::string::npos) {
+        return;
+    }
+    try {
+        for (const KernelInfo& info : program.getKernelInfo(device)) {
+            if (info.spills()) {
+                std::cerr << "ocl: warning: kernel " << info.name << " spills " << info.spill_mem_size
+                          << " bytes per work-item to memory on " << device.getName() << "\n";
+            }
+        }
+    } catch (const Error&) {
+        // Diagnostics only; the build itself succeeded
+    }
+}
+
+} // namespace
+
 void Program::build(const Device& device, const std::string& options) {
+    OCL_PROFILE_SCOPE("Program::build");
     cl_device_id device_id = device.id();
+    auto start = std::chrono::steady_clock::now();
     cl_int err = clBuildProgram(program_, 1, &device_id, 
                                options.empty() ? nullptr : options.c_str(),
                                nullptr, nullptr);
+    detail::recordProgramBuild(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
     
     if (err != CL_SUCCESS) {
         throw Error(err, "building program: " + getBuildLog(device));
     }
+    warnSpills(*this, device);
+}
+
+void Program::setSpillWarnings(bool enabled) {
+    g_spill_warnings.store(enabled, std::memory_order_relaxed);
+}
+
+bool Program::getSpillWarnings() {
+    return g_spill_warnings.load(std::memory_order_relaxed);
+}
+
+std::vector<KernelInfo> Program::getKernelInfo(const Device& device) const {
+    cl_uint count = 0;
+    cl_int err = clCreateKernelsInProgram(program_, 0, nullptr, &count);
+    checkError(err, "counting program kernels");
+    
+    std::vector<cl_kernel> handles(count);
+    if (count > 0) {
+        err = clCreateKernelsInProgram(program_, count, handles.data(), nullptr);
+        checkError(err, "creating program kernels");
+    }
+    std::vector<Kernel> kernels;
+    kernels.reserve(count);
+    for (cl_kernel handle : handles) {
+        kernels.emplace_back(handle);
+    }
+    
+    std::vector<KernelInfo> infos;
+    infos.reserve(count);
+    for (const Kernel& kernel : kernels) {
+        infos.push_back(kernel.getInfo(device));
+    }
+    return infos;
 }
 
 std::string Program::getBuildLog(const Device& device) const {
@@ -107,13 +295,16 @@ Program Program::fromBinary(const Context& context, const Device& device, const
         throw std::runtime_error("Failed to read binary file: " + filepath);
     }
     
+    return fromBinary(context, device, binary.data(), file_size);
+}
+
+Program Program::fromBinary(const Context& context, const Device& device, const unsigned char* binary, size_t size) {
     // Create program from binary
     Program prog;
     cl_int err, binary_status;
     cl_device_id device_id = device.id();
-    const unsigned char* binary_ptr = binary.data();
     
-    prog.program_ = clCreateProgramWithBinary(context.get(), 1, &device_id, &file_size, &binary_ptr, &binary_status, &err);
+    prog.program_ = clCreateProgramWithBinary(context.get(), 1, &device_id, &size, &binary, &binary_status, &err);
     checkError(err, "creating program from binary");
     checkError(binary_status, "binary status");
     
@@ -124,12 +315,19 @@ Program Program::fromBinary(const Context& context, const Device& device, const
     return prog;
 }
 
-void Program::buildOptimized(const Device& device) {
+std::string Program::getOptimizedOptions() {
     // Common optimization flags for OpenCL
-    std::string opts = "-cl-fast-relaxed-math "   // Fast math
-                       "-cl-mad-enable "            // Multiply-add fusion
-                       "-cl-no-signed-zeros "       // Assume no signed zeros
-                       "-cl-finite-math-only";      // Assume finite math
+    return "-cl-fast-relaxed-math "   // Fast math
+           "-cl-mad-enable "            // Multiply-add fusion
+           "-cl-no-signed-zeros "       // Assume no signed zeros
+           "-cl-finite-math-only";      // Assume finite math
+}
+
+void Program::buildOptimized(const Device& device, const std::string& extra_options) {
+    std::string opts = getOptimizedOptions();
+    if (!extra_options.empty()) {
+        opts += " " + extra_options;
+    }
     build(device, opts);
 }
 
@@ -140,5 +338,129 @@ void Program::buildDebug(const Device& device) {
     build(device, opts);
 }
 
-} // namespace ocl
+namespace {
+
+// Sorted -D options followed by the extra build options
+std::string definitionKey(const Definitions& definitions, const std::string& options) {
+    std::vector<std::string> defines;
+    defines.reserve(definitions.size());
+    for (const auto& def : definitions) {
+        defines.push_back(def.toOption());
+    }
+    std::sort(defines.begin(), defines.end());
+    
+    std::string key;
+    for (const auto& define : defines) {
+        key += define + " ";
+    }
+    return key + options;
+}
+
+} // namespace
 
+uint64_t Program::hashDefinitions(const Definitions& definitions, const std::string& options) {
+    return detail::fnv1a(definitionKey(definitions, options));
+}
+
+Program Program::buildCached(const Context& context, const Device& device, const KernelSource& source,
+                             const std::string& options, const std::string& cache_dir) {
+    std::string dir = cache_dir;
+    if (dir.empty()) {
+        const char* env = std::getenv("OCL_BINARY_CACHE");
+        dir = env ? env : "";
+    }
+    
+    // Includes the loader could not resolve are read by the compiler (e.g.
+    // through -I), outside the hash: such a source is never cached
+    std::string path;
+    if (!dir.empty() && source.unresolved.empty()) {
+        const std::string key = source.getHashString() + "\n" + options + "\n" +
+                                device.getName() + "\n" + device.getDriverVersion();
+        std::string base = source.name.substr(source.name.find_last_of("/\\:") + 1);
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(detail::fnv1a(key)));
+        path = dir + "/" + base + "-" + hex + ".bin";
+        
+        std::ifstream cached(path, std::ios::binary);
+        if (cached.is_open()) {
+            cached.close();
+            try {
+                return fromBinary(context, device, path);
+            } catch (const std::exception&) {
+                // Unreadable or rejected by the driver - rebuild and overwrite
+            }
+        }
+    }
+    
+    Program prog(context, source.text);
+    prog.build(device, options);
+    if (!path.empty()) {
+        try {
+            prog.saveBinary(device, path);
+        } catch (const std::exception&) {
+            // Caching is best effort (e.g. read-only directory)
+        }
+    }
+    return prog;
+}
+
+Program& Program::specialize(const Definitions& definitions, const std::string& options) {
+    OCL_PROFILE_SCOPE("Program::specialize");
+    const std::string key = definitionKey(definitions, options);
+    
+    if (!variants_) {
+        variants_.reset(new VariantCache());
+    }
+    auto it = variants_->entries.find(key);
+    if (it != variants_->entries.end()) {
+        detail::recordProgramCache(true);
+        return it->second;
+    }
+    detail::recordProgramCache(false);
+    
+    // Recover source and context from this program
+    size_t source_size;
+    cl_int err = clGetProgramInfo(program_, CL_PROGRAM_SOURCE, 0, nullptr, &source_size);
+    checkError(err, "getting program source size");
+    if (source_size <= 1) {
+        throw std::runtime_error("Cannot specialize a program without source");
+    }
+    std::string source(source_size, '\0');
+    err = clGetProgramInfo(program_, CL_PROGRAM_SOURCE, source_size, &source[0], nullptr);
+    checkError(err, "getting program source");
+    source.pop_back();  // Trailing null
+    
+    cl_context context;
+    err = clGetProgramInfo(program_, CL_PROGRAM_CONTEXT, sizeof(cl_context), &context, nullptr);
+    checkError(err, "getting program context");
+    
+    Program variant;
+    const char* src = source.c_str();
+    size_t length = source.length();
+    variant.program_ = clCreateProgramWithSource(context, 1, &src, &length, &err);
+    checkError(err, "creating specialized program");
+    
+    // Build for all devices in the context
+    auto start = std::chrono::steady_clock::now();
+    err = clBuildProgram(variant.program_, 0, nullptr, key.c_str(), nullptr, nullptr);
+    detail::recordProgramBuild(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    if (err != CL_SUCCESS) {
+        std::string log;
+        cl_uint num_devices = 0;
+        clGetProgramInfo(variant.program_, CL_PROGRAM_NUM_DEVICES, sizeof(cl_uint), &num_devices, nullptr);
+        std::vector<cl_device_id> devices(num_devices);
+        clGetProgramInfo(variant.program_, CL_PROGRAM_DEVICES, num_devices * sizeof(cl_device_id), devices.data(), nullptr);
+        for (auto id : devices) {
+            log += variant.getBuildLog(Device(id));
+        }
+        throw Error(err, "building specialized program (" + key + "): " + log);
+    }
+    
+    return variants_->entries.emplace(key, std::move(variant)).first->second;
+}
+
+size_t Program::getVariantCount() const {
+    return variants_ ? variants_->entries.size() : 0;
+}
+
+} // namespace ocl
@@ -0,0 +1,121 @@
+#include <ocl/QueuePool.hpp>
+#include <ocl/Context.hpp>
+#include <ocl/Device.hpp>
+#include <thread>
+
+namespace ocl {
+
+namespace {
+
+// Sequence number of the calling thread, assigned on first use, so pinned
+// threads spread evenly over the queues
+size_t threadIndex() {
+    static std::atomic<size_t> next{0};
+    static thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+} // namespace
+
+QueuePool::QueuePool(const Context& context, const Device& device, size_t count,
+                     QueueAssignment assignment, cl_command_queue_properties properties)
+    : assignment_(assignment) {
+    if (count == 0) {
+        throw std::invalid_argument("QueuePool needs at least one queue");
+    }
+    
+    slots_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        slots_.emplace_back(new Slot());
+        slots_.back()->queue = CommandQueue(context, device, properties);
+    }
+}
+
+QueuePool::~QueuePool() {
+    // Completion callbacks reference the slots: drain everything first.
+    // Callbacks may run shortly after clFinish returns, so also wait for them.
+    for (auto& slot : slots_) {
+        clFinish(slot->queue.get());
+    }
+    for (auto& slot : slots_) {
+        while (slot->depth.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+size_t QueuePool::select() const {
+    const size_t start = threadIndex() % slots_.size();
+    if (assignment_ == QueueAssignment::Pinned) {
+        return start;
+    }
+    
+    // Least loaded, preferring the thread's own queue on ties
+    size_t best = start;
+    size_t best_depth = slots_[start]->depth.load(std::memory_order_relaxed);
+    for (size_t i = 1; i < slots_.size() && best_depth > 0; ++i) {
+        const size_t index = (start + i) % slots_.size();
+        const size_t depth = slots_[index]->depth.load(std::memory_order_relaxed);
+        if (depth < best_depth) {
+            best = index;
+            best_depth = depth;
+        }
+    }
+    return best;
+}
+
+void QueuePool::track(Slot& slot, const Event& event, int64_t submit_ns) {
+    const uint64_t ns = static_cast<uint64_t>(submit_ns);
+    slot.submissions.fetch_add(1, std::memory_order_relaxed);
+    slot.submit_ns.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t max = slot.max_submit_ns.load(std::memory_order_relaxed);
+    while (ns > max && !slot.max_submit_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+    
+    slot.depth.fetch_add(1, std::memory_order_relaxed);
+    cl_int err = clSetEventCallback(event.get(), CL_COMPLETE, &QueuePool::onComplete, &slot);
+    if (err != CL_SUCCESS) {
+        slot.depth.fetch_sub(1, std::memory_order_relaxed);
+        checkError(err, "setting queue completion callback");
+    }
+}
+
+void CL_CALLBACK QueuePool::onComplete(cl_event, cl_int, void* slot) {
+    // Also called with a negative status when the command failed
+    static_cast<Slot*>(slot)->depth.fetch_sub(1, std::memory_order_release);
+}
+
+void QueuePool::flush() {
+    for (auto& slot : slots_) {
+        slot->queue.flush();
+    }
+}
+
+void QueuePool::finish() {
+    for (auto& slot : slots_) {
+        slot->queue.finish();
+    }
+}
+
+QueueMetrics QueuePool::getMetrics(size_t index) const {
+    const Slot& slot = *slots_.at(index);
+    QueueMetrics metrics;
+    metrics.depth = slot.depth.load(std::memory_order_relaxed);
+    metrics.submissions = slot.submissions.load(std::memory_order_relaxed);
+    metrics.mean_submit_us = metrics.submissions > 0
+        ? slot.submit_ns.load(std::memory_order_relaxed) / 1000.0 / metrics.submissions
+        : 0.0;
+    metrics.max_submit_us = slot.max_submit_ns.load(std::memory_order_relaxed) / 1000.0;
+    return metrics;
+}
+
+std::vector<QueueMetrics> QueuePool::getMetrics() const {
+    std::vector<QueueMetrics> metrics;
+    metrics.reserve(slots_.size());
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        metrics.push_back(getMetrics(i));
+    }
+    return metrics;
+}
+
+} // namespace ocl
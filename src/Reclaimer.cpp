@@ -0,0 +1,299 @@
+#include <ocl/Reclaimer.hpp>
+#include <ocl/Event.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace ocl {
+
+namespace {
+
+enum class HandleKind : uint8_t { Mem, Kernel, Program, Event };
+
+struct Handle {
+    HandleKind kind;
+    void* ptr;
+};
+
+void releaseNow(const Handle& handle) {
+    switch (handle.kind) {
+        case HandleKind::Mem:     clReleaseMemObject(static_cast<cl_mem>(handle.ptr)); break;
+        case HandleKind::Kernel:  clReleaseKernel(static_cast<cl_kernel>(handle.ptr)); break;
+        case HandleKind::Program: clReleaseProgram(static_cast<cl_program>(handle.ptr)); break;
+        case HandleKind::Event:   clReleaseEvent(static_cast<cl_event>(handle.ptr)); break;
+    }
+}
+
+// Bounded multi-producer/multi-consumer queue (Vyukov): each cell's
+// sequence number says whether it is free for the producer at `pos` or
+// filled for the consumer at `pos`
+class HandleQueue {
+public:
+    static const size_t kSize = OCL_RELEASE_QUEUE_SIZE;
+    static_assert((kSize & (kSize - 1)) == 0, "OCL_RELEASE_QUEUE_SIZE must be a power of two");
+    
+    HandleQueue() {
+        for (size_t i = 0; i < kSize; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    bool push(const Handle& handle) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & (kSize - 1)];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->handle = handle;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    
+    bool pop(Handle& handle) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & (kSize - 1)];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        handle = cell->handle;
+        cell->sequence.store(pos + kSize, std::memory_order_release);
+        return true;
+    }
+    
+    size_t size() const {
+        const size_t enqueued = enqueue_pos_.load(std::memory_order_relaxed);
+        const size_t dequeued = dequeue_pos_.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+    
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Handle handle;
+    };
+    
+    Cell cells_[kSize];
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<size_t> dequeue_pos_{0};
+};
+
+// Checked by the release hooks; outlives ReclaimerState, so wrappers
+// destroyed during static destruction fall back to releasing inline
+std::atomic<bool> g_deferred{false};
+std::atomic<bool> g_state_alive{false};
+
+struct ReclaimerState {
+    HandleQueue queue;
+    std::atomic<uint64_t> queued{0};
+    std::atomic<uint64_t> released{0};
+    
+    std::mutex mutex;                // Guards the thread and the idle wait
+    std::condition_variable wake;
+    std::atomic<bool> sleeping{false};
+    bool stop = false;
+    std::thread thread;
+    
+    ReclaimerState() { g_state_alive.store(true); }
+    
+    ~ReclaimerState() {
+        g_deferred.store(false);
+        g_state_alive.store(false);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_one();
+        if (thread.joinable()) {
+            thread.join();
+        }
+        drain();
+    }
+    
+    size_t drain() {
+        size_t count = 0;
+        Handle handle;
+        while (queue.pop(handle)) {
+            releaseNow(handle);
+            released.fetch_add(1, std::memory_order_release);
+            ++count;
+        }
+        return count;
+    }
+    
+    void ensureThread() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!thread.joinable() && !stop) {
+            thread = std::thread([this]() { run(); });
+        }
+    }
+    
+    void run() {
+        for (;;) {
+            drain();
+            std::unique_lock<std::mutex> lock(mutex);
+            if (stop) {
+                return;
+            }
+            // Dekker handshake with enqueue(): announce the sleep, then
+            // re-check the queue. Either this check sees the new handle or
+            // the producer sees `sleeping` and notifies under the mutex.
+            sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            wake.wait(lock, [this]() { return stop || queue.size() > 0; });
+            sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+    
+    void enqueue(const Handle& handle) {
+        if (!queue.push(handle)) {
+            releaseNow(handle);  // Full: never lose a handle
+            return;
+        }
+        queued.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);  // Pairs with run()
+        if (sleeping.load(std::memory_order_relaxed)) {
+            // Under the mutex the sleeper is either before its check or
+            // already waiting, so the notification cannot be lost
+            std::lock_guard<std::mutex> lock(mutex);
+            wake.notify_one();
+        }
+    }
+};
+
+ReclaimerState& state() {
+    static ReclaimerState instance;
+    return instance;
+}
+
+void release(HandleKind kind, void* ptr) {
+    const Handle handle = {kind, ptr};
+    if (g_deferred.load(std::memory_order_relaxed) && g_state_alive.load(std::memory_order_relaxed)) {
+        state().enqueue(handle);
+    } else {
+        releaseNow(handle);
+    }
+}
+
+// Runs on a driver thread: queue the reference, never release here
+void CL_CALLBACK releaseOnComplete(cl_event, cl_int, void* user_data) {
+    Handle* handle = static_cast<Handle*>(user_data);
+    if (g_state_alive.load(std::memory_order_relaxed)) {
+        state().enqueue(*handle);
+    } else {
+        releaseNow(*handle);
+    }
+    delete handle;
+}
+
+void holdHandle(const Event& event, HandleKind kind, void* ptr) {
+    if (!event.isValid()) {
+        throw std::runtime_error("Cannot hold a handle until an invalid event");
+    }
+    state().ensureThread();
+    Handle* handle = new Handle{kind, ptr};
+    cl_int err = clSetEventCallback(event.get(), CL_COMPLETE, releaseOnComplete, handle);
+    if (err != CL_SUCCESS) {
+        delete handle;
+        releaseNow({kind, ptr});
+        checkError(err, "setting reclaim callback");
+    }
+}
+
+} // namespace
+
+void Reclaimer::setMode(ReleaseMode mode) {
+    if (mode == ReleaseMode::Deferred) {
+        state().ensureThread();
+    }
+    g_deferred.store(mode == ReleaseMode::Deferred);
+}
+
+ReleaseMode Reclaimer::getMode() {
+    return g_deferred.load() ? ReleaseMode::Deferred : ReleaseMode::Immediate;
+}
+
+void Reclaimer::flush() {
+    if (!g_state_alive.load()) {
+        return;
+    }
+    ReclaimerState& s = state();
+    const uint64_t target = s.queued.load(std::memory_order_acquire);
+    s.drain();
+    // Handles the background thread dequeued but is still releasing
+    while (s.released.load(std::memory_order_acquire) < target) {
+        std::this_thread::yield();
+    }
+}
+
+size_t Reclaimer::getPendingCount() {
+    return g_state_alive.load() ? state().queue.size() : 0;
+}
+
+uint64_t Reclaimer::getReleasedCount() {
+    return g_state_alive.load() ? state().released.load() : 0;
+}
+
+void Reclaimer::hold(const Event& event, cl_mem mem) {
+    checkError(clRetainMemObject(mem), "retaining buffer");
+    holdHandle(event, HandleKind::Mem, mem);
+}
+
+void Reclaimer::hold(const Event& event, cl_kernel kernel) {
+    checkError(clRetainKernel(kernel), "retaining kernel");
+    holdHandle(event, HandleKind::Kernel, kernel);
+}
+
+void Reclaimer::hold(const Event& event, cl_program program) {
+    checkError(clRetainProgram(program), "retaining program");
+    holdHandle(event, HandleKind::Program, program);
+}
+
+void Reclaimer::hold(const Event& event, cl_event other) {
+    checkError(clRetainEvent(other), "retaining event");
+    holdHandle(event, HandleKind::Event, other);
+}
+
+namespace detail {
+
+void releaseMemObject(cl_mem mem) {
+    release(HandleKind::Mem, mem);
+}
+
+void releaseKernel(cl_kernel kernel) {
+    release(HandleKind::Kernel, kernel);
+}
+
+void releaseProgram(cl_program program) {
+    release(HandleKind::Program, program);
+}
+
+void releaseEvent(cl_event event) {
+    release(HandleKind::Event, event);
+}
+
+} // namespace detail
+
+} // namespace ocl
@@ -1,10 +1,185 @@
 #include <ocl/Registry.hpp>
 #include <ocl/Device.hpp>
 #include <ocl/Platform.hpp>
+#include <ocl/Context.hpp>
+#include <ocl/CommandQueue.hpp>
+#include <ocl/Program.hpp>
+#include <ocl/KernelFunctor.hpp>
+#include <ocl/Benchmark.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
 
 namespace ocl {
 
+namespace {
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+// OCL_DEVICE_TYPE, or CL_DEVICE_TYPE_ALL when unset
+cl_device_type typeOverride() {
+    const char* env = std::getenv("OCL_DEVICE_TYPE");
+    if (!env || !*env) {
+        return CL_DEVICE_TYPE_ALL;
+    }
+    const std::string type = toLower(env);
+    if (type == "gpu") return CL_DEVICE_TYPE_GPU;
+    if (type == "cpu") return CL_DEVICE_TYPE_CPU;
+    if (type == "accelerator") return CL_DEVICE_TYPE_ACCELERATOR;
+    if (type == "all") return CL_DEVICE_TYPE_ALL;
+    throw std::invalid_argument("OCL_DEVICE_TYPE must be gpu, cpu, accelerator or all (got " + type + ")");
+}
+
+// Empty if `device` meets every requirement, else the first one it fails
+std::string checkRequirements(const Device& device, const DevicePolicy& policy, cl_device_type env_type) {
+    if (!(device.getType() & policy.type) || !(device.getType() & env_type)) {
+        return "device type";
+    }
+    if (device.getGlobalMemSize() < policy.min_global_mem) {
+        return "global memory below " + std::to_string(policy.min_global_mem / (1024 * 1024)) + " MB";
+    }
+    if (device.getVersionNumber() < policy.min_version) {
+        return "OpenCL version below " + std::to_string(policy.min_version);
+    }
+    if (policy.require_fp64 && !device.supportsFP64()) {
+        return "no fp64";
+    }
+    for (const auto& extension : policy.extensions) {
+        if (!device.hasExtension(extension)) {
+            return "missing " + extension;
+        }
+    }
+    return "";
+}
+
+// Rough peak from declared capabilities. SIMT width is not queryable, so
+// GPUs count 32 lanes per compute unit; CPUs their float vector width.
+double capabilityScore(const Device& device) {
+    const double lanes = device.isGPU() ? 32.0 : std::max<cl_uint>(1, device.getPreferredVectorWidthFloat());
+    return device.getMaxComputeUnits() * (device.getMaxClockFrequency() / 1000.0) * lanes;
+}
+
+struct ProbeResult {
+    double gb_per_s;
+    double gflop_per_s;
+};
+
+// STREAM triad and FMA chain from roofline.cl, a few hundred ms per device
+ProbeResult probeDevice(const Device& device) {
+    Context ctx(device);
+    CommandQueue queue(ctx, device, CL_QUEUE_PROFILING_ENABLE);
+    Program prog = Program::buildEmbedded(ctx, device, "roofline.cl");
+    KernelFunctor<Buffer<float>, Buffer<float>, Buffer<float>, float, int> triad(prog, "stream_triad");
+    KernelFunctor<Buffer<float>, float, int> fma_peak(prog, "fma_peak");
+    
+    BenchmarkConfig config;
+    config.warmup_iterations = 1;
+    config.min_samples = 5;
+    config.max_samples = 50;
+    config.min_time_ms = 20.0;
+    config.max_time_ms = 200.0;
+    config.print = false;
+    Benchmark bench(config);
+    
+    // 64 MB operands, or what the device allows
+    const size_t n = static_cast<size_t>(std::min<cl_ulong>(16 * 1024 * 1024,
+        std::min(device.getMaxMemAllocSize(), device.getGlobalMemSize() / 4) / sizeof(float)));
+    Buffer<float> a(ctx, n), b(ctx, n), c(ctx, n);
+    const auto& bandwidth = bench.runEvent("triad", [&]() {
+        return triad(queue, Range::of1D(n), a, b, c, 3.0f, static_cast<int>(n));
+    }, 3.0 * n * sizeof(float));
+    
+    const size_t items = std::max<size_t>(65536, device.getMaxComputeUnits() * 4096);
+    const int iterations = 1024;
+    Buffer<float> out(ctx, items);
+    const auto& compute = bench.runEvent("fma_peak", [&]() {
+        return fma_peak(queue, Range::of1D(items), out, 1.0f, iterations);
+    }, 0.0, 32.0 * items * iterations);
+    
+    return {bandwidth.getGBPerSecond(), compute.getGFLOPPerSecond()};
+}
+
+// Creates `dir` (not its parents) if missing
+bool ensureDirectory(const std::string& dir) {
+    struct stat info;
+    if (stat(dir.c_str(), &info) == 0) {
+        return (info.st_mode & S_IFDIR) != 0;
+    }
+#ifdef _WIN32
+    return _mkdir(dir.c_str()) == 0;
+#else
+    return mkdir(dir.c_str(), 0755) == 0;
+#endif
+}
+
+// ~/.cache (created on first use), else the temporary directory
+std::string scoreCachePath(const DevicePolicy& policy) {
+    if (!policy.cache_path.empty()) {
+        return policy.cache_path;
+    }
+    if (const char* env = std::getenv("OCL_DEVICE_CACHE")) {
+        return env;
+    }
+    const char* home = std::getenv("HOME");
+    if (home && *home && ensureDirectory(std::string(home) + "/.cache")) {
+        return std::string(home) + "/.cache/ocl_device_scores.tsv";
+    }
+    const char* tmp = std::getenv("TMPDIR");
+    if (!tmp || !*tmp) {
+        tmp = std::getenv("TEMP");
+    }
+#ifdef _WIN32
+    return tmp && *tmp ? std::string(tmp) + "\\ocl_device_scores.tsv" : "";
+#else
+    return std::string(tmp && *tmp ? tmp : "/tmp") + "/ocl_device_scores.tsv";
+#endif
+}
+
+// Keyed by platform, device and driver version: a driver update re-probes
+std::string scoreCacheKey(const Device& device) {
+    std::string key = device.getPlatform().getName() + " | " + device.getName() + " | " + device.getDriverVersion();
+    std::replace(key.begin(), key.end(), '\t', ' ');
+    return key;
+}
+
+ProbeResult measuredScore(const Device& device, const std::string& cache_path) {
+    const std::string key = scoreCacheKey(device);
+    if (!cache_path.empty()) {
+        std::ifstream cache(cache_path);
+        std::string line;
+        while (std::getline(cache, line)) {
+            std::istringstream fields(line);
+            std::string cached_key;
+            ProbeResult result;
+            if (std::getline(fields, cached_key, '\t') && cached_key == key &&
+                fields >> result.gb_per_s >> result.gflop_per_s) {
+                return result;
+            }
+        }
+    }
+    
+    ProbeResult result = probeDevice(device);
+    if (!cache_path.empty()) {
+        std::ofstream cache(cache_path, std::ios::app);
+        cache << key << '\t' << result.gb_per_s << '\t' << result.gflop_per_s << "\n";
+    }
+    return result;
+}
+
+} // namespace
+
 Registry& Registry::instance() {
     static Registry registry;
     if (!registry.initialized_) {
@@ -53,6 +228,101 @@ Device Registry::getDefaultDevice() const {
     return allDevices[0];
 }
 
+std::vector<DeviceScore> Registry::rankDevices(const DevicePolicy& policy) const {
+    const cl_device_type env_type = typeOverride();
+    const std::string cache_path = scoreCachePath(policy);
+    const double w = std::min(1.0, std::max(0.0, policy.bandwidth_weight));
+    
+    std::vector<DeviceScore> scores;
+    for (const auto& device : getAllDevices()) {
+        DeviceScore entry;
+        entry.device = device;
+        entry.reason = checkRequirements(device, policy, env_type);
+        entry.eligible = entry.reason.empty();
+        if (entry.eligible) {
+            if (policy.ranking == DevicePolicy::Ranking::Measured) {
+                // A device that cannot run the probe drops out of the ranking
+                try {
+                    ProbeResult probe = measuredScore(device, cache_path);
+                    entry.gb_per_s = probe.gb_per_s;
+                    entry.gflop_per_s = probe.gflop_per_s;
+                    entry.score = std::pow(probe.gb_per_s, w) * std::pow(probe.gflop_per_s, 1.0 - w);
+                } catch (const Error& e) {
+                    entry.eligible = false;
+                    entry.reason = std::string("probe failed: ") + e.what();
+                }
+            } else {
+                entry.score = capabilityScore(device);
+            }
+        }
+        scores.push_back(entry);
+    }
+    
+    std::stable_sort(scores.begin(), scores.end(), [](const DeviceScore& a, const DeviceScore& b) {
+        return a.eligible != b.eligible ? a.eligible : a.score > b.score;
+    });
+    return scores;
+}
+
+Device Registry::selectDevice(const DevicePolicy& policy) const {
+    std::vector<DeviceScore> ranked = rankDevices(policy);
+    
+    const char* forced = std::getenv("OCL_DEVICE");
+    if (forced && *forced) {
+        // Resolve the override to device ids. All digits is a global index
+        // and digits:digits a platform:index position, never a name
+        const std::string selector = forced;
+        const size_t colon = selector.find(':');
+        auto isNumber = [](const std::string& text) {
+            return !text.empty() && std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c) != 0; });
+        };
+        const bool by_index = isNumber(selector);
+        const bool by_position = colon != std::string::npos && isNumber(selector.substr(0, colon)) &&
+                                 isNumber(selector.substr(colon + 1));
+        std::vector<cl_device_id> matches;
+        size_t global_index = 0;
+        for (size_t p = 0; p < platforms_.size(); ++p) {
+            auto devices = Device::getAll(platforms_[p]);
+            for (size_t d = 0; d < devices.size(); ++d, ++global_index) {
+                bool match;
+                if (by_index) {
+                    match = std::strtoull(selector.c_str(), nullptr, 10) == global_index;
+                } else if (by_position) {
+                    match = std::strtoull(selector.c_str(), nullptr, 10) == p &&
+                            std::strtoull(selector.c_str() + colon + 1, nullptr, 10) == d;
+                } else {
+                    match = toLower(devices[d].getName()).find(toLower(selector)) != std::string::npos;
+                }
+                if (match) {
+                    matches.push_back(devices[d].id());
+                }
+            }
+        }
+        
+        // Best-ranked match
+        for (const auto& entry : ranked) {
+            if (std::find(matches.begin(), matches.end(), entry.device.id()) == matches.end()) {
+                continue;
+            }
+            if (!entry.eligible) {
+                throw Error(CL_DEVICE_NOT_FOUND, "OCL_DEVICE=" + selector + " (" + entry.device.getName() +
+                            ") does not meet the device policy: " + entry.reason);
+            }
+            return entry.device;
+        }
+        throw Error(CL_DEVICE_NOT_FOUND, "OCL_DEVICE=" + selector + " matches no device");
+    }
+    
+    if (ranked.empty()) {
+        throw Error(CL_DEVICE_NOT_FOUND, "no devices found in registry");
+    }
+    if (!ranked[0].eligible) {
+        throw Error(CL_DEVICE_NOT_FOUND, "no device meets the device policy (" + ranked[0].device.getName() +
+                    ": " + ranked[0].reason + ")");
+    }
+    return ranked[0].device;
+}
+
 const Platform& Registry::getPlatform(size_t index) const {
     if (index >= platforms_.size()) {
         throw std::out_of_range("Platform index out of range");
@@ -69,6 +339,23 @@ size_t Registry::getDeviceCount() const {
     return count;
 }
 
+std::map<std::string, std::string> Registry::getDeviceMetadata(const Device& device) const {
+    Platform platform = device.getPlatform();
+    
+    std::string type = device.isGPU() ? "GPU" : device.isCPU() ? "CPU" : device.isAccelerator() ? "Accelerator" : "Other";
+    return {
+        {"platform", platform.getName()},
+        {"platform_version", platform.getVersion()},
+        {"device", device.getName()},
+        {"device_type", type},
+        {"device_vendor", device.getVendor()},
+        {"device_version", device.getVersion()},
+        {"driver_version", device.getDriverVersion()},
+        {"compute_units", std::to_string(device.getMaxComputeUnits())},
+        {"global_mem_mb", std::to_string(device.getGlobalMemSize() / (1024 * 1024))},
+    };
+}
+
 void Registry::printInfo() const {
     std::cout << "OpenCL Registry\n";
     std::cout << "===============\n";
@@ -0,0 +1,147 @@
+#include <ocl/SourceLoader.hpp>
+#include <ocl/Embedded.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <regex>
+#include <sstream>
+
+namespace ocl {
+
+namespace {
+
+const char* const kEmbeddedPrefix = "embedded:";
+
+std::string directoryOf(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? "" : path.substr(0, slash);
+}
+
+std::string joinPath(const std::string& directory, const std::string& file) {
+    if (directory.empty() || file.empty() || file[0] == '/') {
+        return file;
+    }
+    char last = directory.back();
+    return (last == '/' || last == '\\') ? directory + file : directory + "/" + file;
+}
+
+} // namespace
+
+std::string KernelSource::getHashString() const {
+    std::ostringstream out;
+    out << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return out.str();
+}
+
+void SourceLoader::addIncludeDirectory(const std::string& directory) {
+    directories_.push_back(directory);
+}
+
+bool SourceLoader::resolve(const std::string& include, bool quoted, const std::string& directory,
+                           std::string& id, std::string& text) const {
+    // Quoted includes of an embedded file look among embedded files first
+    if (quoted && directory == kEmbeddedPrefix) {
+        if (const EmbeddedFile* file = findEmbedded(include)) {
+            id = kEmbeddedPrefix + include;
+            text = file->str();
+            return true;
+        }
+    } else if (quoted && detail::tryReadFile(joinPath(directory, include), text)) {
+        id = joinPath(directory, include);
+        return true;
+    }
+    
+    for (const auto& dir : directories_) {
+        if (detail::tryReadFile(joinPath(dir, include), text)) {
+            id = joinPath(dir, include);
+            return true;
+        }
+    }
+    
+    if (search_embedded_) {
+        if (const EmbeddedFile* file = findEmbedded(include)) {
+            id = kEmbeddedPrefix + include;
+            text = file->str();
+            return true;
+        }
+    }
+    return false;
+}
+
+void SourceLoader::expand(const std::string& id, const std::string& text, const std::string& directory,
+                          Expansion& expansion, std::string& out) const {
+    static const std::regex include_line(R"(^\s*#\s*include\s*([<"])([^>"]+)[>"].*$)");
+    static const std::regex pragma_once(R"(^\s*#\s*pragma\s+once\b.*$)");
+    
+    expansion.stack.push_back(id);
+    std::istringstream lines(text);
+    std::string line;
+    size_t number = 0;
+    while (std::getline(lines, line)) {
+        ++number;
+        const size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line[first] != '#') {
+            out += line + "\n";
+            continue;
+        }
+        std::smatch match;
+        if (std::regex_match(line, pragma_once)) {
+            expansion.once.insert(id);
+            out += "\n";  // Keep line numbers
+            continue;
+        }
+        if (!std::regex_match(line, match, include_line)) {
+            out += line + "\n";
+            continue;
+        }
+        
+        std::string child_id, child_text;
+        if (!resolve(match[2], match[1] == "\"", directory, child_id, child_text)) {
+            expansion.result->unresolved.push_back(match[2]);
+            out += line + "\n";
+            continue;
+        }
+        if (std::find(expansion.stack.begin(), expansion.stack.end(), child_id) != expansion.stack.end()) {
+            throw std::runtime_error("Circular #include of " + child_id + " in " + id);
+        }
+        auto& deps = expansion.result->dependencies;
+        if (std::find(deps.begin(), deps.end(), child_id) == deps.end()) {
+            deps.push_back(child_id);
+        }
+        if (expansion.once.count(child_id)) {
+            out += "\n";
+            continue;
+        }
+        
+        const bool embedded = child_id.compare(0, std::string(kEmbeddedPrefix).size(), kEmbeddedPrefix) == 0;
+        out += "#line 1 \"" + child_id + "\"\n";
+        expand(child_id, child_text, embedded ? kEmbeddedPrefix : directoryOf(child_id), expansion, out);
+        out += "#line " + std::to_string(number + 1) + " \"" + id + "\"\n";
+    }
+    expansion.stack.pop_back();
+}
+
+KernelSource SourceLoader::load(const std::string& name, const std::string& text, const std::string& directory) const {
+    KernelSource source;
+    source.name = name;
+    
+    Expansion expansion;
+    expansion.result = &source;
+    expand(name, text, directory, expansion, source.text);
+    
+    source.hash = detail::fnv1a(source.text);
+    return source;
+}
+
+KernelSource SourceLoader::loadFile(const std::string& path) const {
+    return load(path, readFile(path), directoryOf(path));
+}
+
+KernelSource SourceLoader::loadEmbedded(const std::string& name) const {
+    const EmbeddedFile* file = findEmbedded(name);
+    if (!file) {
+        throw std::runtime_error("No embedded kernel source: " + name);
+    }
+    return load(name, file->str(), kEmbeddedPrefix);
+}
+
+} // namespace ocl
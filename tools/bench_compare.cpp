@@ -0,0 +1,119 @@
+#include <ocl/Benchmark.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+
+// Compare two result files written by `benchmark --json` (or any
+// Benchmark::writeJSON output) and flag significant changes.
+//
+// Usage: bench_compare baseline.json candidate.json [--z 3.0] [--min-change 2.0]
+//
+// Exits with 1 if any benchmark regressed, so it can gate a CI job.
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " baseline.json candidate.json [--z 3.0] [--min-change 2.0]\n";
+        return 2;
+    }
+    
+    double z_threshold = 3.0;
+    double min_change_pct = 2.0;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--z") {
+            z_threshold = std::atof(argv[i + 1]);
+        } else if (flag == "--min-change") {
+            min_change_pct = std::atof(argv[i + 1]);
+        }
+    }
+    
+    ocl::Benchmark baseline, candidate;
+    if (!baseline.readJSON(argv[1])) {
+        std::cerr << "Cannot read " << argv[1] << "\n";
+        return 2;
+    }
+    if (!candidate.readJSON(argv[2])) {
+        std::cerr << "Cannot read " << argv[2] << "\n";
+        return 2;
+    }
+    
+    std::cout << "\nBenchmark Comparison\n";
+    std::cout << "══════════════════════════════════════════════════════════════════════════════════════\n";
+    
+    // Environment: differences here (driver, device) often explain the results
+    const auto& base_meta = baseline.getMetadata();
+    const auto& cand_meta = candidate.getMetadata();
+    std::set<std::string> keys;
+    for (const auto& entry : base_meta) keys.insert(entry.first);
+    for (const auto& entry : cand_meta) keys.insert(entry.first);
+    
+    for (const auto& key : keys) {
+        auto b = base_meta.find(key);
+        auto c = cand_meta.find(key);
+        std::string base_value = b != base_meta.end() ? b->second : "-";
+        std::string cand_value = c != cand_meta.end() ? c->second : "-";
+        std::cout << std::left << std::setw(18) << key << base_value;
+        if (cand_value != base_value) {
+            std::cout << "  →  " << cand_value << "  (changed)";
+        }
+        std::cout << "\n";
+    }
+    std::cout << "══════════════════════════════════════════════════════════════════════════════════════\n\n";
+    
+    std::cout << std::left << std::setw(34) << "Benchmark"
+              << std::right << std::setw(12) << "Baseline"
+              << std::setw(12) << "Candidate"
+              << std::setw(10) << "Change"
+              << std::setw(8) << "z"
+              << "  Verdict\n";
+    std::cout << "──────────────────────────────────────────────────────────────────────────────────────\n";
+    
+    std::map<std::string, const ocl::BenchmarkResult*> base_results;
+    for (const auto& result : baseline.getResults()) {
+        base_results[result.name] = &result;
+    }
+    
+    int regressions = 0, improvements = 0;
+    std::set<std::string> seen;
+    for (const auto& result : candidate.getResults()) {
+        seen.insert(result.name);
+        auto match = base_results.find(result.name);
+        if (match == base_results.end()) {
+            std::cout << std::left << std::setw(34) << result.name << std::right << std::setw(12) << "-"
+                      << std::fixed << std::setprecision(4) << std::setw(9) << result.median_ms << " ms"
+                      << "                    new\n";
+            continue;
+        }
+        
+        auto cmp = ocl::Benchmark::compare(*match->second, result, z_threshold, min_change_pct);
+        const char* verdict = "";
+        switch (cmp.change) {
+            case ocl::BenchmarkChange::Regression:  verdict = "✗ REGRESSION"; ++regressions; break;
+            case ocl::BenchmarkChange::Improvement: verdict = "✓ improved"; ++improvements; break;
+            case ocl::BenchmarkChange::Unchanged:   verdict = "~"; break;
+        }
+        std::cout << std::left << std::setw(34) << cmp.name
+                  << std::right << std::fixed << std::setprecision(4)
+                  << std::setw(9) << cmp.baseline_ms << " ms"
+                  << std::setw(9) << cmp.candidate_ms << " ms"
+                  << std::showpos << std::setprecision(1) << std::setw(9) << cmp.change_pct << "%"
+                  << std::setw(8) << (std::isfinite(cmp.z_score) ? cmp.z_score : 0.0) << std::noshowpos
+                  << "  " << verdict << "\n";
+    }
+    for (const auto& entry : base_results) {
+        if (!seen.count(entry.first)) {
+            std::cout << std::left << std::setw(34) << entry.first << std::right << std::fixed << std::setprecision(4)
+                      << std::setw(9) << entry.second->median_ms << " ms" << std::setw(12) << "-"
+                      << "                    removed\n";
+        }
+    }
+    
+    std::cout << "\n" << regressions << " regression(s), " << improvements << " improvement(s)"
+              << " (|z| >= " << std::setprecision(1) << z_threshold
+              << ", change >= " << min_change_pct << "%)\n";
+    
+    return regressions > 0 ? 1 : 0;
+}